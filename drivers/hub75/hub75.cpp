@@ -35,6 +35,11 @@ Hub75::Hub75(uint width, uint height, Pixel *buffer, PanelType panel_type, bool
         back_buffer = buffer;
         managed_buffer = false;
     }
+    front_buffer = back_buffer;
+
+    chain_width = width;
+    scan_rows = height / 2;
+    build_layout_runs();
 
     if (brightness == 0) {
         if (width >= 64) brightness = 6;
@@ -42,50 +47,226 @@ Hub75::Hub75(uint width, uint height, Pixel *buffer, PanelType panel_type, bool
         if (width >= 128) brightness = 2;
         if (width >= 160) brightness = 1;
     }
+
+    build_luts();
 }
 
-void Hub75::set_color(uint x, uint y, Pixel c) {
-    int offset = 0;
-    if(x >= width || y >= height) return;
-    if(y >= height / 2) {
-        y -= height / 2;
-        offset = (y * width + x) * 2;
-        offset += 1;
-    } else {
-        offset = (y * width + x) * 2;
+void Hub75::build_luts() {
+    // Pixel(a, b, c) puts a in the low 10 bits, b in the middle and c at the top
+    uint r_shift = 0, g_shift = 10, b_shift = 20;
+    switch(color_order) {
+        case COLOR_ORDER::RGB: r_shift = 0;  g_shift = 10; b_shift = 20; break;
+        case COLOR_ORDER::RBG: r_shift = 0;  g_shift = 20; b_shift = 10; break;
+        case COLOR_ORDER::GRB: r_shift = 10; g_shift = 0;  b_shift = 20; break;
+        case COLOR_ORDER::GBR: r_shift = 20; g_shift = 0;  b_shift = 10; break;
+        case COLOR_ORDER::BRG: r_shift = 10; g_shift = 20; b_shift = 0;  break;
+        case COLOR_ORDER::BGR: r_shift = 20; g_shift = 10; b_shift = 0;  break;
+    }
+
+    // Scale to (2^bit_depth - 1) << dropped at most, leaving room to add a
+    // threshold below 1 << dropped without carrying into the next channel
+    const uint dropped = BIT_DEPTH - bit_depth;
+    const uint32_t levels = (1u << bit_depth) - 1;
+    for(auto i = 0u; i < 256; i++) {
+        uint32_t v = (GAMMA_10BIT[i] * (levels << dropped) + 511) / 1023;
+        lut_r[i] = v << r_shift;
+        lut_g[i] = v << g_shift;
+        lut_b[i] = v << b_shift;
+    }
+
+    uint32_t mask = 0x3ff & ~((1u << dropped) - 1);
+    quantize_mask = mask | (mask << 10) | (mask << 20);
+    uint32_t half = dropped ? 1u << (dropped - 1) : 0;
+    quantize_round = half | (half << 10) | (half << 20);
+
+    lut_order = color_order;
+}
+
+void Hub75::build_thresholds(uint32_t thresholds[16]) {
+    static const uint8_t bayer[16] = {
+        0, 8, 2, 10,
+        12, 4, 14, 6,
+        3, 11, 1, 9,
+        15, 7, 13, 5
+    };
+    const uint dropped = BIT_DEPTH - bit_depth;
+    for(auto i = 0u; i < 16; i++) {
+        uint32_t t = quantize_round;
+        if(dither && dropped) {
+            // stepping by 7 visits all 16 thresholds in 16 frames
+            t = ((bayer[i] + dither_frame * 7) & 15) >> (4 - dropped);
+            t |= (t << 10) | (t << 20);
+        }
+        thresholds[i] = t;
+    }
+    dither_frame++;
+}
+
+bool Hub75::set_bit_depth(uint depth) {
+    if(refreshing || depth < MIN_BIT_DEPTH || depth > BIT_DEPTH) return false;
+    bit_depth = depth;
+    build_luts();
+    return true;
+}
+
+int32_t Hub75::buffer_offset(uint x, uint y) const {
+    if(x >= width || y >= height) return -1;
+
+    if(!tile_count) {
+        // Top half of the panel on even pixels, bottom half on odd
+        const uint half = height / 2;
+        return y < half ? (y * width + x) * 2 : ((y - half) * width + x) * 2 + 1;
+    }
+
+    for(auto i = 0u; i < tile_count; i++) {
+        const PanelTile &tile = tiles[i];
+        bool turned = tile.rotation == PANEL_ROTATE_90 || tile.rotation == PANEL_ROTATE_270;
+        uint w = turned ? panel_height : panel_width;
+        uint h = turned ? panel_width : panel_height;
+        if(x < tile.x || y < tile.y || x >= tile.x + w || y >= tile.y + h) continue;
+
+        // Canvas to panel coordinates
+        uint u = x - tile.x, v = y - tile.y;
+        uint px = u, py = v;
+        switch(tile.rotation) {
+            case PANEL_ROTATE_0:   px = u;                    py = v;                     break;
+            case PANEL_ROTATE_90:  px = v;                    py = panel_height - 1 - u;  break;
+            case PANEL_ROTATE_180: px = panel_width - 1 - u;  py = panel_height - 1 - v;  break;
+            case PANEL_ROTATE_270: px = panel_width - 1 - v;  py = u;                     break;
+        }
+
+        // Panel coordinates to the chain
+        const uint half = panel_height / 2;
+        const uint stripes = half / scan_rows;
+        uint row = (py % half) % scan_rows;
+        uint stripe = (py % half) / scan_rows;
+        uint column = (i * stripes + stripes - 1 - stripe) * panel_width + px;
+        return (row * chain_width + column) * 2 + (py >= half ? 1 : 0);
+    }
+    return -1;
+}
+
+bool Hub75::build_layout_runs() {
+    // Counts the runs, or fills them in once there's somewhere to put them
+    auto build = [&](layout_run_t *runs, uint *rows) -> int {
+        uint count = 0;
+        for(auto y = 0u; y < height; y++) {
+            if(rows) rows[y] = count;
+            layout_run_t run = {0, 0, 0, 2};
+            for(auto x = 0u; x < width; x++) {
+                int32_t offset = buffer_offset(x, y);
+                if(offset < 0) return -1;
+
+                if(run.length == 1) {
+                    run.step = offset - (int32_t)run.offset;
+                    run.length++;
+                    continue;
+                }
+                if(run.length > 1 && offset == (int32_t)run.offset + run.step * run.length) {
+                    run.length++;
+                    continue;
+                }
+                if(run.length) {
+                    if(runs) runs[count] = run;
+                    count++;
+                }
+                run = {uint16_t(x), 1, uint32_t(offset), 2};
+            }
+            if(runs) runs[count] = run;
+            count++;
+        }
+        if(rows) rows[height] = count;
+        return count;
+    };
+
+    int count = build(nullptr, nullptr);
+    if(count < 0) return false;
+
+    delete[] layout_runs;
+    delete[] layout_rows;
+    layout_runs = new layout_run_t[count];
+    layout_rows = new uint[height + 1];
+    build(layout_runs, layout_rows);
+    return true;
+}
+
+bool Hub75::set_layout(uint panel_width, uint panel_height, const PanelTile *tiles, uint count, uint scan_rows) {
+    if(refreshing || count == 0 || panel_width == 0 || panel_height < 2 || panel_height % 2) return false;
+    if(scan_rows == 0) scan_rows = panel_height / 2;
+
+    // Every address has to light the same number of rows, and there are five address lines
+    if((panel_height / 2) % scan_rows || scan_rows > 32) return false;
+    if(count * panel_width * panel_height != width * height) return false;
+    uint chain_width = count * panel_width * (panel_height / 2 / scan_rows);
+    if(chain_width > 65536) return false;
+
+    PanelTile *old_tiles = this->tiles;
+    uint old_count = tile_count, old_panel_width = this->panel_width, old_panel_height = this->panel_height;
+    uint old_chain_width = this->chain_width, old_scan_rows = this->scan_rows;
+
+    this->tiles = new PanelTile[count];
+    std::copy(tiles, tiles + count, this->tiles);
+    tile_count = count;
+    this->panel_width = panel_width;
+    this->panel_height = panel_height;
+    this->chain_width = chain_width;
+    this->scan_rows = scan_rows;
+
+    // The panels have to cover the canvas exactly, which build_layout_runs() checks
+    if(!build_layout_runs()) {
+        delete[] this->tiles;
+        this->tiles = old_tiles;
+        tile_count = old_count;
+        this->panel_width = old_panel_width;
+        this->panel_height = old_panel_height;
+        this->chain_width = old_chain_width;
+        this->scan_rows = old_scan_rows;
+        return false;
+    }
+    delete[] old_tiles;
+
+    // The refresh is a different shape now, start() makes new command lists
+    free_dma_commands();
+    return true;
+}
+
+bool Hub75::set_grid_layout(uint panel_width, uint panel_height, uint columns, uint rows, bool serpentine, uint scan_rows) {
+    if(columns * panel_width != width || rows * panel_height != height) return false;
+
+    // Shift order starts from the far end of the chain, the bottom row. Like
+    // a single chain, a row's first panel in shift order is on the left
+    // unless it's been turned around
+    const uint count = columns * rows;
+    PanelTile *tiles = new PanelTile[count];
+    for(auto i = 0u; i < count; i++) {
+        uint row = rows - 1 - i / columns;
+        uint column = i % columns;
+        bool reversed = serpentine && row % 2;
+        if(reversed) column = columns - 1 - column;
+        tiles[i] = {column * panel_width, row * panel_height, reversed ? PANEL_ROTATE_180 : PANEL_ROTATE_0};
     }
+    bool result = set_layout(panel_width, panel_height, tiles, count, scan_rows);
+    delete[] tiles;
+    return result;
+}
+
+void Hub75::set_color(uint x, uint y, Pixel c) {
+    int32_t offset = buffer_offset(x, y);
+    if(offset < 0) return;
     back_buffer[offset] = c;
 }
 
 void Hub75::set_pixel(uint x, uint y, uint8_t r, uint8_t g, uint8_t b) {
-    switch(color_order) {
-        case COLOR_ORDER::RGB:
-            set_color(x, y, Pixel(r, g, b));
-            break;
-        case COLOR_ORDER::RBG:
-            set_color(x, y, Pixel(r, b, g));
-            break;
-        case COLOR_ORDER::GRB:
-            set_color(x, y, Pixel(g, r, b));
-            break;
-        case COLOR_ORDER::GBR:
-            set_color(x, y, Pixel(g, b, r));
-            break;
-        case COLOR_ORDER::BRG:
-            set_color(x, y, Pixel(b, r, g));
-            break;
-        case COLOR_ORDER::BGR:
-            set_color(x, y, Pixel(b, g, r));
-            break;
-    }
+    if(lut_order != color_order) build_luts();
+    set_color(x, y, quantize(lut_pixel(r, g, b), quantize_round));
 }
 
 void Hub75::FM6126A_write_register(uint16_t value, uint8_t position) {
     gpio_put(pin_clk, !clk_polarity);
     gpio_put(pin_stb, !stb_polarity);
 
-    uint8_t threshold = width - position;
-    for(auto i = 0u; i < width; i++) {
+    uint threshold = chain_width - position;
+    for(auto i = 0u; i < chain_width; i++) {
         auto j = i % 16;
         bool b = value & (1 << j);
 
@@ -111,9 +292,126 @@ void Hub75::FM6126A_setup() {
     FM6126A_write_register(0b0000001000000000, 13);
 }
 
+void Hub75::build_row_headers() {
+    // Only the top bit_depth bits of each channel are shown, the lowest of
+    // them getting the shortest pulse
+    const uint rows = scan_rows;
+    const uint dropped = BIT_DEPTH - bit_depth;
+    for(auto plane = 0u; plane < bit_depth; plane++) {
+        for(auto row = 0u; row < rows; row++) {
+            uint32_t *header = &row_headers[(plane * rows + row) * 2];
+            header[0] = (chain_width - 1) | (hub75_data_rgb888_shift_instr(plane + dropped) << 16);
+            header[1] = row | (brightness << 5 << plane);
+        }
+    }
+    header_brightness = brightness;
+}
+
+void Hub75::build_dma_commands(dma_command_t *commands, const Pixel *buffer) {
+    const uint rows = scan_rows;
+
+    // Headers go to the data SM's FIFO and the row SM's straight after it
+    dma_channel_config config = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_dreq(&config, pio_get_dreq(pio, sm_data, true));
+    channel_config_set_chain_to(&config, dma_ctrl_channel);
+    uint32_t header_ctrl = channel_config_get_ctrl_value(&config);
+
+    channel_config_set_write_increment(&config, false);
+    uint32_t pixels_ctrl = channel_config_get_ctrl_value(&config);
+
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_dreq(&config, DREQ_FORCE);
+    uint32_t loop_ctrl = channel_config_get_ctrl_value(&config);
+
+    dma_command_t *command = commands;
+    for(auto plane = 0u; plane < bit_depth; plane++) {
+        for(auto row = 0u; row < rows; row++) {
+            *command++ = {header_ctrl, &row_headers[(plane * rows + row) * 2], &pio->txf[sm_data], 2};
+            *command++ = {pixels_ctrl, &buffer[row * chain_width * 2], &pio->txf[sm_data], chain_width * 2};
+        }
+    }
+
+    // Send the control channel back to the first block, of whichever list is
+    // current by then
+    *command++ = {loop_ctrl, &dma_commands_start, &dma_hw->ch[dma_ctrl_channel].read_addr, 1};
+}
+
+void Hub75::free_dma_commands() {
+    if(back_commands != front_commands) {
+        delete[] back_commands;
+    }
+    delete[] front_commands;
+    delete[] row_headers;
+    front_commands = nullptr;
+    back_commands = nullptr;
+    row_headers = nullptr;
+}
+
+bool Hub75::set_double_buffered(Pixel *buffer) {
+    if(refreshing) return false;
+    if(double_buffer) return true;
+    if(buffer) {
+        double_buffer = buffer;
+    } else {
+        double_buffer = new Pixel[width * height];
+        managed_double_buffer = true;
+    }
+    back_buffer = double_buffer;
+    return true;
+}
+
+void Hub75::swap_buffers() {
+    if(front_buffer == back_buffer) return;
+
+    // Only one swap can be waiting for the end of a refresh
+    wait_for_swap();
+    std::swap(front_buffer, back_buffer);
+    std::swap(front_commands, back_commands);
+    dma_commands_start = front_commands;
+}
+
+bool Hub75::swap_pending() const {
+    if(!refreshing) return false;
+
+    // The swap has happened once the control channel is working through the new list
+    const dma_command_t *current = (const dma_command_t *)dma_hw->ch[dma_ctrl_channel].read_addr;
+    return current < front_commands || current > front_commands + dma_commands_length();
+}
+
+void Hub75::wait_for_swap() const {
+    while(swap_pending()) {
+        tight_loop_contents();
+    }
+}
+
+float Hub75::get_refresh_rate(uint refreshes) const {
+    if(!refreshing || refreshes == 0) return 0.0f;
+
+    // The control channel's read address drops back to the start of a list once a refresh
+    auto wait_for_wrap = [&]() {
+        uintptr_t last = (uintptr_t)dma_hw->ch[dma_ctrl_channel].read_addr;
+        while(true) {
+            uintptr_t current = (uintptr_t)dma_hw->ch[dma_ctrl_channel].read_addr;
+            if(current < last) break;
+            last = current;
+        }
+    };
+
+    wait_for_wrap();
+    uint64_t start = time_us_64();
+    for(auto i = 0u; i < refreshes; i++) {
+        wait_for_wrap();
+    }
+    return refreshes * 1000000.0f / (time_us_64() - start);
+}
+
 void Hub75::start(irq_handler_t handler) {
     if(handler) {
         dma_channel = 0;
+        dma_ctrl_channel = 1;
 
         // Try as I might, I can't seem to coax MicroPython into leaving PIO in a known state upon soft reset
         // check for claimed PIO and prepare a clean slate.
@@ -127,6 +425,10 @@ void Hub75::start(irq_handler_t handler) {
         pio_sm_claim(pio, sm_data);
         pio_sm_claim(pio, sm_row);
 
+        // Both SMs start out waiting for each other
+        pio_interrupt_clear(pio, 4);
+        pio_interrupt_clear(pio, 5);
+
         data_prog_offs = pio_add_program(pio, &hub75_data_rgb888_program);
         if (inverted_stb) {
             row_prog_offs = pio_add_program(pio, &hub75_row_inverted_program);
@@ -137,47 +439,48 @@ void Hub75::start(irq_handler_t handler) {
         hub75_row_program_init(pio, sm_row, row_prog_offs, ROWSEL_BASE_PIN, ROWSEL_N_PINS, pin_stb);
 
         // Prevent flicker in Python caused by the smaller dataset just blasting through the PIO too quickly
-        pio_sm_set_clkdiv(pio, sm_data, width <= 32 ? 2.0f : 1.0f);
+        pio_sm_set_clkdiv(pio, sm_data, chain_width <= 32 ? 2.0f : 1.0f);
+
+        if(!row_headers) row_headers = new uint32_t[BIT_DEPTH * scan_rows * 2];
+        if(!front_commands) front_commands = new dma_command_t[dma_commands_length()];
+        if(back_buffer == front_buffer) {
+            back_commands = front_commands;
+        } else if(back_commands == front_commands || !back_commands) {
+            back_commands = new dma_command_t[dma_commands_length()];
+        }
+        build_row_headers();
 
         dma_channel_claim(dma_channel);
-        dma_channel_config config = dma_channel_get_default_config(dma_channel);
+        dma_channel_claim(dma_ctrl_channel);
+        build_dma_commands(front_commands, front_buffer);
+        if(back_commands != front_commands) build_dma_commands(back_commands, back_buffer);
+        dma_commands_start = front_commands;
+
+        // The control channel copies one block at a time into the data channel's
+        // registers, the last write triggering it
+        dma_channel_config config = dma_channel_get_default_config(dma_ctrl_channel);
         channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
-        channel_config_set_bswap(&config, false);
-        channel_config_set_dreq(&config, pio_get_dreq(pio, sm_data, true));
-        dma_channel_configure(dma_channel, &config, &pio->txf[sm_data], NULL, 0, false);
-
-
-        // Same handler for both DMA channels
-        irq_set_exclusive_handler(DMA_IRQ_0, handler);
-        irq_set_exclusive_handler(DMA_IRQ_1, handler);
-
-        dma_channel_set_irq0_enabled(dma_channel, true);
-
-        irq_set_enabled(pio_get_dreq(pio, sm_data, true), true);
-        irq_set_enabled(DMA_IRQ_0, true);
-
-
-        row = 0;
-        bit = 0;
-
-        hub75_data_rgb888_set_shift(pio, sm_data, data_prog_offs, bit);
-        dma_channel_set_trans_count(dma_channel, width * 2, false);
-        dma_channel_set_read_addr(dma_channel, &back_buffer, true);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_ring(&config, true, 4); // wrap the writes around the four registers
+        dma_channel_configure(dma_ctrl_channel, &config, &dma_hw->ch[dma_channel].al1_ctrl, front_commands, 4, true);
+        refreshing = true;
     }
 }
 
 void Hub75::stop(irq_handler_t handler) {
-
-    irq_set_enabled(DMA_IRQ_0, false);
-    irq_set_enabled(DMA_IRQ_1, false);
-    irq_set_enabled(pio_get_dreq(pio, sm_data, true), false);
+    refreshing = false;
+
+    if(dma_channel_is_claimed(dma_ctrl_channel)) {
+        // Chain both channels to themselves so neither can restart the other, then stop them
+        dma_hw->ch[dma_ctrl_channel].al1_ctrl = (dma_hw->ch[dma_ctrl_channel].al1_ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (dma_ctrl_channel << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+        dma_hw->ch[dma_channel].al1_ctrl = (dma_hw->ch[dma_channel].al1_ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (dma_channel << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+        dma_channel_abort(dma_ctrl_channel);
+        dma_channel_unclaim(dma_ctrl_channel);
+    }
 
     if(dma_channel_is_claimed(dma_channel)) {
-        dma_channel_set_irq0_enabled(dma_channel, false);
-        irq_remove_handler(DMA_IRQ_0, handler);
-        //dma_channel_wait_for_finish_blocking(dma_channel);
         dma_channel_abort(dma_channel);
-        dma_channel_acknowledge_irq0(dma_channel);
         dma_channel_unclaim(dma_channel);
     }
 
@@ -204,9 +507,17 @@ void Hub75::stop(irq_handler_t handler) {
 }
 
 Hub75::~Hub75() {
+    // whichever of the two isn't the double buffer came from the constructor
     if (managed_buffer) {
-        delete[] back_buffer;
+        delete[] (back_buffer == double_buffer ? front_buffer : back_buffer);
     }
+    if (managed_double_buffer) {
+        delete[] double_buffer;
+    }
+    free_dma_commands();
+    delete[] tiles;
+    delete[] layout_runs;
+    delete[] layout_rows;
 }
 
 void Hub75::clear() {
@@ -219,65 +530,65 @@ void Hub75::clear() {
 
 
 void Hub75::dma_complete() {
+}
 
-    if(dma_channel_get_irq0_status(dma_channel)) {
-        dma_channel_acknowledge_irq0(dma_channel);
-
-        // Push out a dummy pixel for each row
-        pio_sm_put_blocking(pio, sm_data, 0);
-        pio_sm_put_blocking(pio, sm_data, 0);
-
-        // SM is finished when it stalls on empty TX FIFO
-        hub75_wait_tx_stall(pio, sm_data);
-
-        // Check that previous OEn pulse is finished, else things WILL get out of sequence
-        hub75_wait_tx_stall(pio, sm_row);
-
-        // Latch row data, pulse output enable for new row.
-        pio_sm_put_blocking(pio, sm_row, row | (brightness << 5 << bit));
-
-        row++;
-
-        if(row == height / 2) {
-            row = 0;
-            bit++;
-            if (bit == BIT_DEPTH) {
-                bit = 0;
+// Rows are converted straight into the interleaved layout the DMA reads,
+// through the runs the panel layout maps each row to
+template<typename T, typename F>
+void Hub75::convert(const T *src, const uint32_t thresholds[16], F pixel) {
+    for(uint y = 0; y < height; y++) {
+        const T *row = src + y * width;
+        const uint32_t *t = &thresholds[(y & 3) * 4];
+        for(auto run = &layout_runs[layout_rows[y]]; run < &layout_runs[layout_rows[y + 1]]; run++) {
+            Pixel *dest = &back_buffer[run->offset];
+            for(uint x = run->x; x < uint(run->x + run->length); x++) {
+                *dest = quantize(pixel(row[x]), t[x & 3]);
+                dest += run->step;
             }
-            hub75_data_rgb888_set_shift(pio, sm_data, data_prog_offs, bit);
         }
-
-        dma_channel_set_trans_count(dma_channel, width * 2, false);
-        dma_channel_set_read_addr(dma_channel, &back_buffer[row * width * 2], true);
     }
 }
 
 void Hub75::update(PicoGraphics *graphics) {
-    if(graphics->pen_type == PicoGraphics::PEN_RGB888) {
-        uint32_t *p = (uint32_t *)graphics->frame_buffer;
-        for(uint y = 0; y < height; y++) {
-            for(uint x = 0; x < width; x++) {
-                uint32_t col = *p;
-                uint8_t r = (col & 0xff0000) >> 16;
-                uint8_t g = (col & 0x00ff00) >>  8;
-                uint8_t b = (col & 0x0000ff) >>  0;
-                set_pixel(x, y, r, g, b);
-                p++;
-            }
-        }
-    }
-    else if(graphics->pen_type == PicoGraphics::PEN_RGB565) {
-        uint16_t *p = (uint16_t *)graphics->frame_buffer;
-        for(uint y = 0; y < height; y++) {
-            for(uint x = 0; x < width; x++) {
-                uint16_t col = __builtin_bswap16(*p);
-                uint8_t r = (col & 0b1111100000000000) >> 8;
-                uint8_t g = (col & 0b0000011111100000) >> 3;
-                uint8_t b = (col & 0b0000000000011111) << 3;
-                set_pixel(x, y, r, g, b);
-                p++;
+    if(lut_order != color_order) build_luts();
+    if(row_headers && header_brightness != brightness) build_row_headers();
+
+    // The last frame's back buffer is still on the panel until its swap
+    wait_for_swap();
+
+    uint32_t thresholds[16];
+    build_thresholds(thresholds);
+
+    switch(graphics->pen_type) {
+        case PicoGraphics::PEN_RGB888:
+            convert((const uint32_t *)graphics->frame_buffer, thresholds, [&](uint32_t col) {
+                return lut_pixel(col >> 16, col >> 8, col);
+            });
+            break;
+        case PicoGraphics::PEN_RGB565:
+            convert((const uint16_t *)graphics->frame_buffer, thresholds, [&](uint16_t col) {
+                col = __builtin_bswap16(col);
+                return lut_pixel((col >> 8) & 0b11111000, (col >> 3) & 0b11111100, col << 3);
+            });
+            break;
+        case PicoGraphics::PEN_RGB332:
+        case PicoGraphics::PEN_P8: {
+            // both index 256 colours, so resolve every one of them up front
+            Pixel colors[256];
+            RGB *palette = graphics->get_palette();
+            for(auto i = 0u; i < 256; i++) {
+                RGB c = graphics->pen_type == PicoGraphics::PEN_P8 ? palette[i] : RGB((RGB332)i);
+                colors[i] = lut_pixel(c.r, c.g, c.b);
             }
+            convert((const uint8_t *)graphics->frame_buffer, thresholds, [&](uint8_t index) {
+                return colors[index];
+            });
+            break;
         }
+        default:
+            break;
     }
+
+    swap_buffers();
 }
 }
\ No newline at end of file
@@ -12,7 +12,8 @@ const uint DATA_BASE_PIN = 0;
 const uint DATA_N_PINS = 6;
 const uint ROWSEL_BASE_PIN = 6;
 const uint ROWSEL_N_PINS = 5;
-const uint BIT_DEPTH = 10;
+const uint BIT_DEPTH = 10;     // bits per channel in a Pixel, and the most that can be shown
+const uint MIN_BIT_DEPTH = 6;
 
 // This gamma table is used to correct our 8-bit (0-255) colours up to 11-bit,
 // allowing us to gamma correct without losing dynamic range.
@@ -48,6 +49,21 @@ enum PanelType {
     PANEL_FM6126A,
 };
 
+// How far a panel is turned clockwise on the wall
+enum PanelRotation {
+    PANEL_ROTATE_0 = 0,
+    PANEL_ROTATE_90,
+    PANEL_ROTATE_180,
+    PANEL_ROTATE_270,
+};
+
+// Where a panel's top left corner sits on the canvas
+struct PanelTile {
+    uint x;
+    uint y;
+    PanelRotation rotation;
+};
+
 Pixel hsv_to_rgb(float h, float s, float v);
 
 class Hub75 {
@@ -64,15 +80,92 @@ class Hub75 {
     uint height;
     Pixel *back_buffer;
     bool managed_buffer = false;
+
+    // With double buffering, update() and set_pixel() draw into back_buffer
+    // while the panel shows front_buffer, and swap_buffers() exchanges them
+    // at the end of a full refresh so a frame is never shown half drawn.
+    // Single buffered, both point at the same pixels.
+    Pixel *front_buffer;
+    Pixel *double_buffer = nullptr;
+    bool managed_double_buffer = false;
     PanelType panel_type;
     bool inverted_stb = false;
     COLOR_ORDER color_order;
     Pixel background = 0;
 
+    // Gamma corrected channel values already shifted into place for
+    // color_order, so a pixel is three lookups OR'd together. Rebuilt by
+    // update() if color_order is changed
+    uint32_t lut_r[256];
+    uint32_t lut_g[256];
+    uint32_t lut_b[256];
+    COLOR_ORDER lut_order;
+
+    // Showing fewer bit planes refreshes faster. The LUTs scale each channel
+    // to bit_depth bits, keeping the bits below as a fraction, then a
+    // threshold is added and the fraction masked off. The threshold is a
+    // half for plain rounding, or with dither a 4x4 ordered pattern that
+    // moves on every update() so each pixel averages out to its full depth
+    uint bit_depth = BIT_DEPTH;
+    bool dither = false;
+    uint dither_frame = 0;
+    uint32_t quantize_mask;
+    uint32_t quantize_round;
+
+    // Panel layout
+    //
+    // By default the canvas is one chain of panels side by side. A layout
+    // puts each panel of the chain anywhere on the canvas, at any of four
+    // rotations. Tiles are listed in shift order, starting with the panel
+    // at the far end of the chain.
+    //
+    // Panels with fewer row addresses than half their height (1/8 scan on
+    // a 32 pixel high panel, say) light several rows per address. Those
+    // rows share one long shift register, with the upper rows further
+    // along it ("stripe" multiplexing).
+    //
+    // The refresh sees the chain as scan_rows rows of chain_width pixel
+    // pairs. update() writes through layout_runs instead, which map each
+    // canvas row to runs of evenly spaced back buffer pixels, so a layout
+    // costs nothing per refresh.
+    struct layout_run_t {
+        uint16_t x;
+        uint16_t length;
+        uint32_t offset;
+        int32_t step;
+    };
+    uint chain_width;
+    uint scan_rows;
+    uint panel_width = 0;
+    uint panel_height = 0;
+    PanelTile *tiles = nullptr;
+    uint tile_count = 0;
+    layout_run_t *layout_runs = nullptr;
+    uint *layout_rows = nullptr;    // first run of each canvas row, and one past the last
+
     // DMA & PIO
+    //
+    // The panel is refreshed by a chain of DMA control blocks with no CPU
+    // involvement. For every bit plane of every row, one block sends a row
+    // header to the data SM and the row select/OEn width to the row SM
+    // (their FIFOs are adjacent), and the next sends the row's pixels. The
+    // control channel walks the list, writing each block into the data
+    // channel's registers, and the last block points it back at the start.
+    struct dma_command_t {
+        uint32_t ctrl;
+        const volatile void *read_addr;
+        volatile void *write_addr;
+        uint32_t transfer_count;
+    };
+
     uint dma_channel = 0;
-    uint bit = 0;
-    uint row = 0;
+    uint dma_ctrl_channel = 1;
+    dma_command_t *front_commands = nullptr;    // refreshes front_buffer
+    dma_command_t *back_commands = nullptr;     // back_buffer, when double buffered
+    uint32_t *row_headers = nullptr;    // data SM header and row SM command for each row of each bit plane
+    const dma_command_t *volatile dma_commands_start = nullptr;    // where the next refresh begins
+    bool refreshing = false;
+    uint header_brightness = 0;
 
     PIO pio = pio0;
     uint sm_data = 0;
@@ -127,12 +220,47 @@ class Hub75 {
     void FM6126A_write_register(uint16_t value, uint8_t position);
     void FM6126A_setup();
     void set_color(uint x, uint y, Pixel c);
+    void build_luts();
+    Pixel lut_pixel(uint8_t r, uint8_t g, uint8_t b) const {
+        return Pixel(lut_r[r] | lut_g[g] | lut_b[b]);
+    }
+    Pixel quantize(Pixel c, uint32_t threshold) const {
+        return Pixel((c.color + threshold) & quantize_mask);
+    }
+    void build_thresholds(uint32_t thresholds[16]);
+    // between MIN_BIT_DEPTH and BIT_DEPTH, only while stopped
+    bool set_bit_depth(uint depth);
 
     void set_pixel(uint x, uint y, uint8_t r, uint8_t g, uint8_t b);
     void display_update();
     void clear();
+    void build_row_headers();
+    void build_dma_commands(dma_command_t *commands, const Pixel *buffer);
+    uint dma_commands_length() const {return BIT_DEPTH * scan_rows * 2 + 1;}   // room for the most bit planes
+    void free_dma_commands();
+
+    // both only while stopped
+    bool set_layout(uint panel_width, uint panel_height, const PanelTile *tiles, uint count, uint scan_rows = 0);
+    // columns x rows panels, chained row by row from the bottom. With
+    // serpentine, every other row runs the other way with its panels upside down
+    bool set_grid_layout(uint panel_width, uint panel_height, uint columns, uint rows, bool serpentine = false, uint scan_rows = 0);
+    // where canvas pixel x, y lives in the back buffer, or -1 if it's not on a panel
+    int32_t buffer_offset(uint x, uint y) const;
+    bool build_layout_runs();
+    template<typename T, typename F> void convert(const T *src, const uint32_t thresholds[16], F pixel);
+
+    // give the panel a second buffer, from the heap if buffer is nullptr.
+    // Must be called before start()
+    bool set_double_buffered(Pixel *buffer = nullptr);
+    // show back_buffer from the start of the next refresh
+    void swap_buffers();
+    bool swap_pending() const;
+    void wait_for_swap() const;
+    // times whole refreshes of the panel, taking about refreshes / rate seconds
+    float get_refresh_rate(uint refreshes = 4) const;
     void start(irq_handler_t handler);
     void stop(irq_handler_t handler);
+    // nothing to do now refresh doesn't need interrupts, kept for existing handlers
     void dma_complete();
     void update(PicoGraphics *graphics);
     };
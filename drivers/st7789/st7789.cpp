@@ -308,6 +308,63 @@ namespace pimoroni {
     }
   }
 
+  void ST7789::set_window(const Rect &window) {
+    // offsets for the panel and rotation were worked out in configure_display()
+    uint16_t x = __builtin_bswap16(caset[0]) + window.x;
+    uint16_t y = __builtin_bswap16(raset[0]) + window.y;
+    uint16_t cols[2] = {__builtin_bswap16(x), __builtin_bswap16(uint16_t(x + window.w - 1))};
+    uint16_t rows[2] = {__builtin_bswap16(y), __builtin_bswap16(uint16_t(y + window.h - 1))};
+
+    command(reg::CASET, 4, (char *)cols);
+    command(reg::RASET, 4, (char *)rows);
+  }
+
+  void ST7789::wait_for_write() {
+    dma_channel_wait_for_finish_blocking(st_dma);
+
+    // the last few bytes are still on their way out after the DMA finishes
+    if(spi) {
+      while(spi_is_busy(spi))
+        ;
+    } else {
+      uint32_t sm_stall_mask = 1u << (parallel_sm + PIO_FDEBUG_TXSTALL_LSB);
+      parallel_pio->fdebug = sm_stall_mask;
+      while (!(parallel_pio->fdebug & sm_stall_mask))
+        ;
+    }
+  }
+
+  void ST7789::write_begin(const Rect &window) {
+    uint8_t cmd = reg::RAMWR;
+
+    set_window(window);
+
+    gpio_put(dc, 0); // command mode
+    gpio_put(cs, 0);
+    if(spi) {
+      spi_write_blocking(spi, &cmd, 1);
+    } else {
+      write_blocking_parallel(&cmd, 1);
+    }
+    gpio_put(dc, 1); // data mode
+  }
+
+  void ST7789::write_async(const void *data, size_t length) {
+    write_blocking_dma((const uint8_t *)data, length);
+  }
+
+  bool ST7789::write_busy() {
+    return dma_channel_is_busy(st_dma);
+  }
+
+  void ST7789::write_end() {
+    wait_for_write();
+    gpio_put(cs, 1);
+
+    command(reg::CASET, 4, (char *)caset);
+    command(reg::RASET, 4, (char *)raset);
+  }
+
   void ST7789::set_backlight(uint8_t brightness) {
     // gamma correct the provided 0-255 brightness value onto a
     // 0-65535 range for the pwm counter
@@ -132,8 +132,21 @@ namespace pimoroni {
     void update(PicoGraphics *graphics) override;
     void set_backlight(uint8_t brightness) override;
 
+    // Stream big-endian RGB565 pixels into a window of the display without a
+    // framebuffer, e.g. for video. Each write_async() waits for the previous
+    // transfer then starts a DMA of the new one and returns straight away,
+    // so the next strip can be prepared while this one goes out. Buffers
+    // must stay untouched until write_busy() is false. write_end() waits
+    // for the last transfer and puts the full window back for update().
+    void write_begin(const Rect &window);
+    void write_async(const void *data, size_t length);
+    bool write_busy();
+    void write_end();
+
   private:
     void common_init();
+    void set_window(const Rect &window);
+    void wait_for_write();
     void configure_display(Rotation rotate);
     void write_blocking_dma(const uint8_t *src, size_t len);
     void write_blocking_parallel(const uint8_t *src, size_t len);
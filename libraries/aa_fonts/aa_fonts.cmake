@@ -0,0 +1,5 @@
+add_library(aa_fonts 
+    ${CMAKE_CURRENT_LIST_DIR}/aa_fonts.cpp
+)
+
+target_include_directories(aa_fonts INTERFACE ${CMAKE_CURRENT_LIST_DIR})
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstring>
+
+#include "aa_fonts.hpp"
+
+namespace aa {
+  // Decode the UTF-8 character starting at t[i] and advance i past it,
+  // malformed sequences are returned a byte at a time
+  uint32_t next_codepoint(const std::string &t, size_t &i) {
+    uint8_t c = t[i++];
+
+    uint8_t extra = 0;
+    uint32_t codepoint = c;
+    if((c & 0b11100000) == 0b11000000) {extra = 1; codepoint = c & 0b00011111;}
+    else if((c & 0b11110000) == 0b11100000) {extra = 2; codepoint = c & 0b00001111;}
+    else if((c & 0b11111000) == 0b11110000) {extra = 3; codepoint = c & 0b00000111;}
+
+    if(i + extra > t.length()) return c;
+
+    for(auto j = 0u; j < extra; j++) {
+      uint8_t b = t[i + j];
+      if((b & 0b11000000) != 0b10000000) return c;
+      codepoint = (codepoint << 6) | (b & 0b00111111);
+    }
+
+    i += extra;
+    return codepoint;
+  }
+
+  const glyph_t *find_glyph(const font_t *font, uint32_t codepoint) {
+    const glyph_t *end = font->glyphs + font->glyph_count;
+    const glyph_t *g = std::lower_bound(font->glyphs, end, codepoint, [](const glyph_t &g, uint32_t c) {
+      return g.codepoint < c;
+    });
+    return (g != end && g->codepoint == codepoint) ? g : nullptr;
+  }
+
+  int8_t kerning(const font_t *font, uint32_t left, uint32_t right) {
+    // the table only holds 16-bit codepoints, so nothing above can be kerned
+    if(font->kerning_count == 0 || left > 0xffff || right > 0xffff) return 0;
+
+    uint32_t key = (left << 16) | right;
+    const kerning_t *end = font->kerning + font->kerning_count;
+    const kerning_t *k = std::lower_bound(font->kerning, end, key, [](const kerning_t &k, uint32_t key) {
+      return ((uint32_t(k.left) << 16) | k.right) < key;
+    });
+    return (k != end && k->left == left && k->right == right) ? k->adjust : 0;
+  }
+
+  int32_t measure_glyph(const font_t *font, uint32_t codepoint) {
+    const glyph_t *g = find_glyph(font, codepoint);
+    return g ? g->advance : 0;
+  }
+
+  int32_t measure_text(const font_t *font, const std::string &t) {
+    int32_t width = 0;
+    uint32_t last = 0;
+    size_t i = 0;
+    while(i < t.length()) {
+      uint32_t c = next_codepoint(t, i);
+      width += kerning(font, last, c) + measure_glyph(font, c);
+      last = c;
+    }
+    return width;
+  }
+
+  int32_t glyph(const font_t *font, row_func row, uint32_t codepoint, int32_t x, int32_t y) {
+    const glyph_t *g = find_glyph(font, codepoint);
+
+    if(!g) return 0;
+
+    const uint8_t *d = &font->data[g->offset];
+
+    // scale coverage values up to a full 0-255 alpha
+    uint8_t value_mask = (1U << font->bpp) - 1;
+    uint8_t alpha_scale = 255 / value_mask;
+
+    // Runs are written out one after another into a row buffer, ignoring the
+    // edge of the glyph, and each row is drawn in one go once it's full. The
+    // last run may spill over into the next row so the buffer has room for the
+    // widest glyph plus the longest run, which is 128 pixels at 1bpp
+    uint8_t coverage[255 + 128];
+    const uint8_t bpp = font->bpp;
+    const int32_t width = g->width;
+    int32_t gx = 0, gy = 0;
+    x += g->x_offset;
+    y += g->y_offset;
+
+    uint32_t remaining = width * g->height;
+    while(remaining) {
+      uint8_t b = *d++;
+      uint32_t run = std::min(remaining, uint32_t(b >> bpp) + 1);
+      uint8_t alpha = (b & value_mask) * alpha_scale;
+      remaining -= run;
+
+      // most runs are short, so always store 16 bytes rather than branch on
+      // the length, anything past the end of the run is overwritten later
+      memset(&coverage[gx], alpha, 16);
+      if(run > 16) memset(&coverage[gx + 16], alpha, run - 16);
+      gx += run;
+
+      while(gx >= width) {
+        // trim the row to the pixels that have any coverage
+        int32_t first = 0, last = width;
+        while(first < last && !coverage[first]) first++;
+        while(last > first && !coverage[last - 1]) last--;
+        if(first < last) row(x + first, y + gy, last - first, &coverage[first]);
+
+        gx -= width;
+        gy++;
+        memmove(coverage, &coverage[width], gx);
+      }
+    }
+
+    return g->advance;
+  }
+
+  void text(const font_t *font, row_func row, const std::string &t, int32_t x, int32_t y, int32_t wrap) {
+    int32_t co = 0, lo = 0; // character and line (if wrapping) offset
+    uint32_t last = 0;
+
+    size_t i = 0;
+    while(i < t.length()) {
+      // measure the next word, including kerning against the character before it
+      size_t end = i;
+      uint32_t prev = last;
+      int32_t word_width = 0;
+      while(end < t.length() && t[end] != ' ' && t[end] != '\n') {
+        uint32_t c = next_codepoint(t, end);
+        word_width += kerning(font, prev, c) + measure_glyph(font, c);
+        prev = c;
+      }
+
+      // if this word would exceed the wrap limit then move to the next line
+      if(wrap > 0 && co != 0 && co + word_width > wrap) {
+        co = 0;
+        lo += font->line_height;
+        last = 0;
+      }
+
+      // draw word
+      while(i < end) {
+        uint32_t c = next_codepoint(t, i);
+        co += kerning(font, last, c);
+        co += glyph(font, row, c, x + co, y + lo);
+        last = c;
+      }
+
+      if(i < t.length()) {
+        if(t[i] == '\n') {
+          co = 0;
+          lo += font->line_height;
+          last = 0;
+        } else {
+          co += measure_glyph(font, ' ');
+          last = ' ';
+        }
+        i++;
+      }
+    }
+  }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <cstdint>
+
+// Anti-aliased bitmap fonts
+//
+// Glyphs are stored row-major as a stream of run-length encoded coverage
+// values. Each byte holds a coverage value in its low `bpp` bits and the run
+// length minus one in the remaining bits, runs may continue onto the next row.
+// Fonts are generated from TTF/OTF or BDF files with convert.py
+namespace aa {
+  struct glyph_t {
+    uint16_t codepoint;
+    uint8_t width;      // bitmap width
+    uint8_t height;     // bitmap height
+    int8_t x_offset;    // bitmap offset from the pen position
+    int8_t y_offset;    // bitmap offset from the top of the line
+    uint8_t advance;    // distance to move the pen after drawing
+    uint32_t offset;    // start of this glyph's data
+  };
+
+  struct kerning_t {
+    uint16_t left;
+    uint16_t right;
+    int8_t adjust;
+  };
+
+  struct font_t {
+    const uint8_t bpp;            // 1, 2 or 4 bits of coverage per pixel
+    const uint8_t line_height;
+    const uint16_t glyph_count;
+    const uint16_t kerning_count;
+    const glyph_t *glyphs;        // sorted by codepoint
+    const kerning_t *kerning;     // sorted by left then right codepoint
+    const uint8_t *data;
+  };
+
+  // draw a row of w pixels, coverage holds an alpha (0-255) for each of them
+  typedef std::function<void(int32_t x, int32_t y, int32_t w, const uint8_t *coverage)> row_func;
+
+  uint32_t next_codepoint(const std::string &t, size_t &i);
+  const glyph_t *find_glyph(const font_t *font, uint32_t codepoint);
+  int8_t kerning(const font_t *font, uint32_t left, uint32_t right);
+
+  int32_t measure_glyph(const font_t *font, uint32_t codepoint);
+  int32_t measure_text(const font_t *font, const std::string &t);
+
+  int32_t glyph(const font_t *font, row_func row, uint32_t codepoint, int32_t x, int32_t y);
+  void text(const font_t *font, row_func row, const std::string &t, int32_t x, int32_t y, int32_t wrap);
+}
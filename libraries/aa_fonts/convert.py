@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+
+# converts TTF/OTF or BDF fonts into the anti-aliased font format used by
+# PicoGraphics - the result can be piped directly into a .hpp file.
+#
+#   ./convert.py Roboto-Regular.ttf --size 24 --bpp 4 > roboto24_data.hpp
+#   ./convert.py spleen-8x16.bdf > spleen16_data.hpp
+#
+# or into a binary font for an asset pack (see libraries/pico_assets):
+#
+#   ./convert.py Roboto-Regular.ttf --size 24 --binary roboto24.aaf
+#
+# TTF/OTF rendering requires Pillow (pip install pillow), GPOS kerning is only
+# picked up when Pillow has been built with libraqm
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+parser = argparse.ArgumentParser(
+    description="Converts TTF/OTF or BDF fonts into the PicoGraphics anti-aliased font format."
+)
+parser.add_argument("file", help="input font to convert")
+parser.add_argument("--size", type=int, default=16, help="pixel size to render TTF/OTF fonts at")
+parser.add_argument("--bpp", type=int, choices=[1, 2, 4], default=None, help="bits of coverage per pixel (default 4, or 1 for BDF)")
+parser.add_argument("--chars", default="32-126", help="codepoint ranges to include, eg: 32-126,160-255")
+parser.add_argument("--name", default=None, help="name of the generated font")
+parser.add_argument("--no-kerning", action="store_true", help="don't generate a kerning table")
+parser.add_argument("--binary", default=None, help="write a binary font for use in an asset pack instead of a .hpp")
+
+options = parser.parse_args()
+
+
+def parse_ranges(ranges):
+    codepoints = []
+    for r in ranges.split(","):
+        if "-" in r:
+            start, end = r.split("-")
+            codepoints += range(int(start, 0), int(end, 0) + 1)
+        else:
+            codepoints.append(int(r, 0))
+    return sorted(set(codepoints))
+
+
+def load_ttf(path, size, codepoints, bpp, kerning):
+    from PIL import Image, ImageDraw, ImageFont
+
+    layout_engine = ImageFont.Layout.RAQM if ImageFont.core.HAVE_RAQM else ImageFont.Layout.BASIC
+    font = ImageFont.truetype(str(path), size, layout_engine=layout_engine)
+    ascent, descent = font.getmetrics()
+    max_value = (1 << bpp) - 1
+
+    glyphs = []
+    for cp in codepoints:
+        ch = chr(cp)
+        # skip anything the font doesn't actually contain
+        if cp != 32 and font.getmask(ch).getbbox() is None and font.getlength(ch) == 0:
+            continue
+
+        advance = round(font.getlength(ch))
+        left, top, right, bottom = font.getbbox(ch)
+        width, height = max(0, right - left), max(0, bottom - top)
+
+        pixels = []
+        if width and height:
+            image = Image.new("L", (width, height), 0)
+            ImageDraw.Draw(image).text((-left, -top), ch, font=font, fill=255)
+            pixels = [round(v * max_value / 255) for v in image.getdata()]
+
+        glyphs.append({
+            "codepoint": cp, "width": width, "height": height,
+            "x_offset": left, "y_offset": top, "advance": advance, "pixels": pixels
+        })
+
+    pairs = []
+    if kerning:
+        # pair adjustments are whatever the layout engine applies on top of the
+        # individual advances, this picks up both kern and GPOS tables
+        chars = [chr(g["codepoint"]) for g in glyphs]
+        widths = {c: font.getlength(c) for c in chars}
+        for a in chars:
+            for b in chars:
+                adjust = round(font.getlength(a + b) - widths[a] - widths[b])
+                if adjust != 0:
+                    pairs.append((ord(a), ord(b), adjust))
+
+    return ascent + descent, glyphs, pairs
+
+
+def load_bdf(path, codepoints, bpp):
+    max_value = (1 << bpp) - 1
+    lines = path.read_text(errors="replace").splitlines()
+
+    ascent = descent = 0
+    glyphs = []
+    glyph = None
+    bitmap = None
+
+    for line in lines:
+        fields = line.split()
+        if not fields:
+            continue
+        key = fields[0]
+        if key == "FONT_ASCENT":
+            ascent = int(fields[1])
+        elif key == "FONT_DESCENT":
+            descent = int(fields[1])
+        elif key == "STARTCHAR":
+            glyph = {}
+        elif key == "ENCODING":
+            glyph["codepoint"] = int(fields[1])
+        elif key == "DWIDTH":
+            glyph["advance"] = int(fields[1])
+        elif key == "BBX":
+            w, h, xoff, yoff = (int(v) for v in fields[1:5])
+            glyph.update(width=w, height=h, x_offset=xoff, y_offset=ascent - (yoff + h))
+        elif key == "BITMAP":
+            bitmap = []
+        elif key == "ENDCHAR":
+            pixels = []
+            for row in bitmap:
+                bits = int(row, 16) if row else 0
+                total = len(row) * 4
+                pixels += [max_value if bits & (1 << (total - 1 - x)) else 0 for x in range(glyph["width"])]
+            glyph["pixels"] = pixels
+            if glyph["codepoint"] in codepoints:
+                glyphs.append(glyph)
+            glyph = bitmap = None
+        elif bitmap is not None:
+            bitmap.append(key)
+
+    return ascent + descent, sorted(glyphs, key=lambda g: g["codepoint"]), []
+
+
+def rle_encode(pixels, bpp):
+    # each byte is a coverage value in the low bpp bits and the run length
+    # minus one in the remaining bits, runs continue across rows
+    max_run = 256 >> bpp
+    data = []
+    i = 0
+    while i < len(pixels):
+        value = pixels[i]
+        run = 1
+        while i + run < len(pixels) and pixels[i + run] == value and run < max_run:
+            run += 1
+        data.append(((run - 1) << bpp) | value)
+        i += run
+    return data
+
+
+def check_range(glyph, key, low, high):
+    if not low <= glyph[key] <= high:
+        raise ValueError(f"codepoint {glyph['codepoint']}: {key} {glyph[key]} out of range {low} to {high}")
+
+
+def write_binary(filename, bpp, line_height, glyphs, pairs, data):
+    # matches AssetPack::aa_font_header_t followed by the aa::glyph_t and
+    # aa::kerning_t tables as laid out in memory, then the glyph data
+    glyph_table = b"".join(
+        struct.pack("<HBBbbBxI", g["codepoint"], g["width"], g["height"], g["x_offset"], g["y_offset"], g["advance"], g["offset"])
+        for g in glyphs)
+    kerning_table = b"".join(struct.pack("<HHbx", *p) for p in pairs)
+    kerning_table += bytes(-len(kerning_table) % 4)
+
+    glyphs_offset = 20
+    kerning_offset = glyphs_offset + len(glyph_table)
+    data_offset = kerning_offset + len(kerning_table)
+
+    header = struct.pack("<BBHHHIII", bpp, line_height, len(glyphs), len(pairs), 0, glyphs_offset, kerning_offset, data_offset)
+
+    with open(filename, "wb") as f:
+        f.write(header + glyph_table + kerning_table + bytes(data))
+
+
+def convert_font(path):
+    codepoints = parse_ranges(options.chars)
+    is_bdf = path.suffix.lower() == ".bdf"
+    bpp = options.bpp or (1 if is_bdf else 4)
+
+    if is_bdf:
+        line_height, glyphs, pairs = load_bdf(path, codepoints, bpp)
+    else:
+        line_height, glyphs, pairs = load_ttf(path, options.size, codepoints, bpp, not options.no_kerning)
+
+    name = options.name or re.sub(r"\W", "_", path.stem.lower()) + (f"{options.size}" if not is_bdf else "")
+
+    data = []
+    for glyph in glyphs:
+        for key, low, high in (("width", 0, 255), ("height", 0, 255), ("x_offset", -128, 127), ("y_offset", -128, 127), ("advance", 0, 255)):
+            check_range(glyph, key, low, high)
+        glyph["offset"] = len(data)
+        data += rle_encode(glyph["pixels"], bpp)
+
+    pairs = [p for p in sorted(pairs) if -128 <= p[2] <= 127]
+
+    if options.binary:
+        write_binary(options.binary, bpp, line_height, glyphs, pairs, data)
+        return
+
+    print("#pragma once")
+    print("")
+    print('#include "libraries/aa_fonts/aa_fonts.hpp"')
+    print("")
+    print(f"// generated by convert.py from {path.name}, {len(glyphs)} glyphs, {len(data)} bytes of {bpp}bpp data")
+    print("")
+    print(f"const aa::glyph_t {name}_glyphs[] = {{")
+    for g in glyphs:
+        print(f"  {{{g['codepoint']}, {g['width']}, {g['height']}, {g['x_offset']}, {g['y_offset']}, {g['advance']}, {g['offset']}}},")
+    print("};")
+    print("")
+    if pairs:
+        print(f"const aa::kerning_t {name}_kerning[] = {{")
+        for left, right, adjust in pairs:
+            print(f"  {{{left}, {right}, {adjust}}},")
+        print("};")
+        print("")
+    print(f"const uint8_t {name}_data[] = {{")
+    for i in range(0, len(data), 16):
+        print("  " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+    print("};")
+    print("")
+    print(f"const aa::font_t {name} {{")
+    print(f"  .bpp = {bpp},")
+    print(f"  .line_height = {line_height},")
+    print(f"  .glyph_count = {len(glyphs)},")
+    print(f"  .kerning_count = {len(pairs)},")
+    print(f"  .glyphs = {name}_glyphs,")
+    print(f"  .kerning = {name + '_kerning' if pairs else 'nullptr'},")
+    print(f"  .data = {name}_data")
+    print("};")
+
+
+try:
+    convert_font(Path(options.file))
+except ValueError as e:
+    print(f"error: {e}", file=sys.stderr)
+    sys.exit(1)
@@ -0,0 +1,6 @@
+add_library(bcd_matrix INTERFACE)
+
+target_include_directories(bcd_matrix INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+# Pull in pico libraries that we need
+target_link_libraries(bcd_matrix INTERFACE pico_stdlib pico_graphics hardware_pio hardware_dma)
@@ -0,0 +1,607 @@
+#pragma once
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "pico_graphics.hpp"
+
+namespace pimoroni {
+
+  // Drives an LED matrix of constant current column drivers and
+  // multiplexed rows with binary coded decimal (bcd) modulation, as on
+  // Galactic and Cosmic Unicorn.
+  //
+  // A PIO program clocks a bitstream out to the display, fed by two
+  // chained DMA channels that send the whole bitstream again and again
+  // with no CPU involvement. The bitstream has a bcd frame for every bit of
+  // colour depth of every row, each shown for twice as long as the last:
+  //
+  // for each row:
+  //   for each bcd frame:
+  //                     0: row pixel count (minus one)
+  //          PIXEL_OFFSET: xxxxxbgr, xxxxxbgr, ...  // pixel data
+  //     ROW_SELECT_OFFSET: xxxxrrrr                 // row select bits
+  //      BCD_TICKS_OFFSET: tttttttt, ...            // bcd tick count, to the end of the frame
+  //
+  // with the bytes in between left at zero to dword align the frame.
+  //
+  // The board describes its display with a Config of:
+  //
+  //   WIDTH, HEIGHT        the canvas in pixels
+  //   ROW_COUNT            rows the display multiplexes. The canvas is cut
+  //                        into bands of ROW_COUNT rows, which the display
+  //                        puts side by side along its columns, all of them
+  //                        upside down and back to front
+  //   BCD_FRAME_COUNT      bits of colour depth, at most 16
+  //   BCD_FRAME_BYTES, PIXEL_OFFSET, ROW_SELECT_OFFSET, BCD_TICKS_OFFSET
+  //                        the bcd frame layout that its PIO program expects
+  //   COLUMN_CLOCK, COLUMN_DATA, COLUMN_LATCH, COLUMN_BLANK, ROW_BIT_0, ROW_BITS
+  //                        its pins, the column pins followed by the row select
+  //   program(), program_config(offset)
+  //                        its PIO program and the program's default config
+  template<typename Config>
+  class BCDMatrix {
+  public:
+    static constexpr int WIDTH = Config::WIDTH;
+    static constexpr int HEIGHT = Config::HEIGHT;
+
+    static constexpr uint32_t ROW_COUNT = Config::ROW_COUNT;
+    static constexpr uint32_t BANDS = HEIGHT / ROW_COUNT;
+    static constexpr uint32_t COLUMNS = WIDTH * BANDS;
+    static constexpr uint32_t BCD_FRAME_COUNT = Config::BCD_FRAME_COUNT;
+    static constexpr uint32_t BCD_FRAME_BYTES = Config::BCD_FRAME_BYTES;
+    static constexpr uint32_t ROW_BYTES = BCD_FRAME_COUNT * BCD_FRAME_BYTES;
+    static constexpr uint32_t BITSTREAM_LENGTH = ROW_COUNT * ROW_BYTES;
+    static constexpr uint32_t PIXEL_OFFSET = Config::PIXEL_OFFSET;
+    static constexpr uint32_t ROW_SELECT_OFFSET = Config::ROW_SELECT_OFFSET;
+    static constexpr uint32_t BCD_TICKS_OFFSET = Config::BCD_TICKS_OFFSET;
+
+    // bytes of a bcd frame up to the first header byte after the pixels,
+    // all written together by write_row()
+    static constexpr uint32_t ROW_DATA_BYTES = ROW_SELECT_OFFSET > PIXEL_OFFSET && ROW_SELECT_OFFSET < BCD_TICKS_OFFSET ? ROW_SELECT_OFFSET : BCD_TICKS_OFFSET;
+    static constexpr uint32_t ROW_DATA_WORDS = ROW_DATA_BYTES / 4;
+
+    // driver chips in the column chain, each with 16 outputs
+    static constexpr uint32_t DRIVER_COUNT = (COLUMNS * 3 + 15) / 16;
+
+    static_assert(HEIGHT % ROW_COUNT == 0, "the canvas must be a whole number of bands of rows");
+    static_assert(BCD_FRAME_COUNT <= 16, "at most 16 bits of colour depth");
+    static_assert(BCD_FRAME_BYTES % 4 == 0 && ROW_DATA_BYTES % 4 == 0, "bcd frames must be dword aligned");
+    static_assert(PIXEL_OFFSET > 0 && PIXEL_OFFSET + COLUMNS <= ROW_DATA_BYTES, "pixels must fit between the row pixel count and the row select");
+    static_assert((BCD_FRAME_BYTES - BCD_TICKS_OFFSET) * 8 >= BCD_FRAME_COUNT, "bcd tick count is too short for the colour depth");
+    static_assert(Config::COLUMN_CLOCK < Config::ROW_BIT_0, "row select pins must follow the column pins");
+
+  private:
+    static PIO bitstream_pio;
+    static uint bitstream_sm;
+    static uint bitstream_sm_offset;
+    static uint dma_channel;
+    static uint dma_ctrl_channel;
+
+    // the instance the pio and dma are showing
+    static BCDMatrix *active;
+
+    // gamma corrected 0-255 values, scaled to the bcd frame count
+    static uint16_t gamma_lut[256];
+
+    uint16_t brightness = 256;
+
+    // gamma lut with the brightness applied, rebuilt when it changes
+    uint16_t lut[256] = {0};
+
+    // must be aligned for 32bit dma transfer
+    alignas(4) uint8_t bitstream[BITSTREAM_LENGTH] = {0};
+    volatile uint32_t bitstream_addr = (uint32_t)bitstream;   // read by the dma at the start of every pass
+
+    // With double buffering, update() and set_pixel() draw into
+    // back_bitstream while the display shows front_bitstream, and
+    // swap_buffers() points the dma at it from its next pass so a frame is
+    // never shown half drawn. Single buffered, both point at bitstream
+    uint8_t *front_bitstream = bitstream;
+    uint8_t *back_bitstream = bitstream;
+    uint8_t *double_bitstream = nullptr;
+    bool managed_double_bitstream = false;
+
+  public:
+    ~BCDMatrix() {
+      if(managed_double_bitstream) {
+        delete[] double_bitstream;
+      }
+    }
+
+    // sets up the bitstream and the display, then starts the pio and dma.
+    // Any other instance must be stopped first
+    void init();
+    // blanks the display and stops the pio and dma
+    static void stop();
+    // frees the pio and dma, once stopped
+    void release();
+
+    // blanks both bitstreams, so the display goes dark immediately
+    void clear();
+    void update(PicoGraphics *graphics);
+    // double buffered, drawn pixels are shown from the next swap_buffers()
+    void set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b);
+
+    void set_brightness(float value);
+    float get_brightness();
+    void adjust_brightness(float delta);
+
+    // give the display a second bitstream of bitstream_length() bytes, aligned
+    // for 32bit dma transfer, or from the heap if buffer is nullptr
+    bool set_double_buffered(uint8_t *buffer = nullptr);
+    static constexpr uint32_t bitstream_length() { return BITSTREAM_LENGTH; }
+    // show what's been drawn from the start of the next pass
+    void swap_buffers();
+    bool swap_pending();
+    void wait_for_swap();
+
+    static void dma_safe_abort(uint channel);
+
+  private:
+    void build_luts();
+    static void split_lanes(const uint16_t *v, uint32_t &lo, uint32_t &hi);
+    void convert_row(PicoGraphics *graphics, int y, uint32_t last, uint16_t *r, uint16_t *g, uint16_t *b, RGB888 *converted);
+    void write_row(uint32_t row, const uint16_t *r, const uint16_t *g, const uint16_t *b);
+  };
+
+  template<typename Config> PIO BCDMatrix<Config>::bitstream_pio = pio0;
+  template<typename Config> uint BCDMatrix<Config>::bitstream_sm = 0;
+  template<typename Config> uint BCDMatrix<Config>::bitstream_sm_offset = 0;
+  template<typename Config> uint BCDMatrix<Config>::dma_channel = 0;
+  template<typename Config> uint BCDMatrix<Config>::dma_ctrl_channel = 0;
+  template<typename Config> BCDMatrix<Config> *BCDMatrix<Config>::active = nullptr;
+  template<typename Config> uint16_t BCDMatrix<Config>::gamma_lut[256] = {0};
+
+  template<typename Config>
+  void BCDMatrix<Config>::init() {
+    // create the gamma lut, the same for every channel
+    for(uint16_t v = 0; v < 256; v++) {
+      // gamma correct the provided 0-255 brightness value onto the
+      // range of the bcd frames
+      float gamma = 1.8f;
+      gamma_lut[v] = (uint16_t)(powf((float)(v) / 255.0f, gamma) * (float(1U << (BCD_FRAME_COUNT)) - 1.0f) + 0.5f);
+    }
+    build_luts();
+
+    // initialise the bcd timing values and row selects in the bitstream
+    for(uint32_t row = 0; row < ROW_COUNT; row++) {
+      for(uint32_t frame = 0; frame < BCD_FRAME_COUNT; frame++) {
+        // find the offset of this row and frame in the bitstream
+        uint8_t *p = &bitstream[row * ROW_BYTES + (BCD_FRAME_BYTES * frame)];
+
+        p[0] = COLUMNS - 1;                 // row pixel count
+        p[ROW_SELECT_OFFSET] = row;         // row select
+
+        // set the number of bcd ticks for this frame
+        uint32_t bcd_ticks = (1 << frame);
+        for(uint32_t i = BCD_TICKS_OFFSET; i < BCD_FRAME_BYTES; i++) {
+          p[i] = bcd_ticks & 0xff;
+          bcd_ticks >>= 8;
+        }
+      }
+    }
+
+    // a second bitstream needs the same
+    if(double_bitstream) {
+      memcpy(double_bitstream, bitstream, BITSTREAM_LENGTH);
+    }
+
+    gpio_init(Config::COLUMN_CLOCK); gpio_set_dir(Config::COLUMN_CLOCK, GPIO_OUT); gpio_put(Config::COLUMN_CLOCK, false);
+    gpio_init(Config::COLUMN_DATA); gpio_set_dir(Config::COLUMN_DATA, GPIO_OUT); gpio_put(Config::COLUMN_DATA, false);
+    gpio_init(Config::COLUMN_LATCH); gpio_set_dir(Config::COLUMN_LATCH, GPIO_OUT); gpio_put(Config::COLUMN_LATCH, false);
+    gpio_init(Config::COLUMN_BLANK); gpio_set_dir(Config::COLUMN_BLANK, GPIO_OUT); gpio_put(Config::COLUMN_BLANK, true);
+
+    // initialise the row select, and set them to a non-visible row to avoid flashes during setup
+    for(uint i = 0; i < Config::ROW_BITS; i++) {
+      gpio_init(Config::ROW_BIT_0 + i); gpio_set_dir(Config::ROW_BIT_0 + i, GPIO_OUT); gpio_put(Config::ROW_BIT_0 + i, true);
+    }
+
+    sleep_ms(100);
+
+    // configure full output current in register 2
+
+    uint16_t reg1 = 0b1111111111001110;
+
+    // clock the register value to all but the last driver chip
+    for(uint j = 0; j < DRIVER_COUNT - 1; j++) {
+      for(int i = 0; i < 16; i++) {
+        if(reg1 & (1U << (15 - i))) {
+          gpio_put(Config::COLUMN_DATA, true);
+        }else{
+          gpio_put(Config::COLUMN_DATA, false);
+        }
+        sleep_us(10);
+        gpio_put(Config::COLUMN_CLOCK, true);
+        sleep_us(10);
+        gpio_put(Config::COLUMN_CLOCK, false);
+      }
+    }
+
+    // clock the last chip and latch the value
+    for(int i = 0; i < 16; i++) {
+      if(reg1 & (1U << (15 - i))) {
+        gpio_put(Config::COLUMN_DATA, true);
+      }else{
+        gpio_put(Config::COLUMN_DATA, false);
+      }
+
+      sleep_us(10);
+      gpio_put(Config::COLUMN_CLOCK, true);
+      sleep_us(10);
+      gpio_put(Config::COLUMN_CLOCK, false);
+
+      if(i == 4) {
+        gpio_put(Config::COLUMN_LATCH, true);
+      }
+    }
+    gpio_put(Config::COLUMN_LATCH, false);
+
+    // reapply the blank as the above seems to cause a slight glow.
+    // Note, this will produce a brief flash if a visible row is selected (which it shouldn't be)
+    gpio_put(Config::COLUMN_BLANK, false);
+    sleep_us(10);
+    gpio_put(Config::COLUMN_BLANK, true);
+
+    // setup the pio if it has not previously been set up
+    bitstream_pio = pio0;
+    if(active == nullptr) {
+      bitstream_sm = pio_claim_unused_sm(bitstream_pio, true);
+      bitstream_sm_offset = pio_add_program(bitstream_pio, Config::program());
+    }
+
+    pio_gpio_init(bitstream_pio, Config::COLUMN_CLOCK);
+    pio_gpio_init(bitstream_pio, Config::COLUMN_DATA);
+    pio_gpio_init(bitstream_pio, Config::COLUMN_LATCH);
+    pio_gpio_init(bitstream_pio, Config::COLUMN_BLANK);
+
+    for(uint i = 0; i < Config::ROW_BITS; i++) {
+      pio_gpio_init(bitstream_pio, Config::ROW_BIT_0 + i);
+    }
+
+    // set the blank and row pins to be high, then set all led driving pins as outputs.
+    // This order is important to avoid a momentary flash
+    const uint pins_to_set = 1 << Config::COLUMN_BLANK | ((1 << Config::ROW_BITS) - 1) << Config::ROW_BIT_0;
+    pio_sm_set_pins_with_mask(bitstream_pio, bitstream_sm, pins_to_set, pins_to_set);
+    pio_sm_set_consecutive_pindirs(bitstream_pio, bitstream_sm, Config::COLUMN_CLOCK, Config::ROW_BIT_0 + Config::ROW_BITS - Config::COLUMN_CLOCK, true);
+
+    pio_sm_config c = Config::program_config(bitstream_sm_offset);
+
+    // osr shifts right, autopull on, autopull threshold 8
+    sm_config_set_out_shift(&c, true, true, 32);
+
+    // configure out, set, and sideset pins
+    sm_config_set_out_pins(&c, Config::ROW_BIT_0, Config::ROW_BITS);
+    sm_config_set_set_pins(&c, Config::COLUMN_DATA, 3);
+    sm_config_set_sideset_pins(&c, Config::COLUMN_CLOCK);
+
+    // join fifos as only tx needed (gives 8 deep fifo instead of 4)
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+
+    // setup dma transfer for pixel data to the pio
+    dma_channel = dma_claim_unused_channel(true);
+    dma_ctrl_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config ctrl_config = dma_channel_get_default_config(dma_ctrl_channel);
+    channel_config_set_transfer_data_size(&ctrl_config, DMA_SIZE_32);
+    channel_config_set_read_increment(&ctrl_config, false);
+    channel_config_set_write_increment(&ctrl_config, false);
+    channel_config_set_chain_to(&ctrl_config, dma_channel);
+
+    dma_channel_configure(
+      dma_ctrl_channel,
+      &ctrl_config,
+      &dma_hw->ch[dma_channel].read_addr,
+      &bitstream_addr,
+      1,
+      false
+    );
+
+    dma_channel_config config = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_bswap(&config, false); // byte swap to reverse little endian
+    channel_config_set_dreq(&config, pio_get_dreq(bitstream_pio, bitstream_sm, true));
+    channel_config_set_chain_to(&config, dma_ctrl_channel);
+
+    dma_channel_configure(
+      dma_channel,
+      &config,
+      &bitstream_pio->txf[bitstream_sm],
+      NULL,
+      BITSTREAM_LENGTH / 4,
+      false);
+
+    pio_sm_init(bitstream_pio, bitstream_sm, bitstream_sm_offset, &c);
+
+    pio_sm_set_enabled(bitstream_pio, bitstream_sm, true);
+
+    // start the control channel
+    dma_start_channel_mask(1u << dma_ctrl_channel);
+
+    active = this;
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::stop() {
+    // Stop the bitstream SM
+    pio_sm_set_enabled(bitstream_pio, bitstream_sm, false);
+
+    // Make sure the display is off and switch it to an invisible row, to be safe
+    const uint pins_to_set = 1 << Config::COLUMN_BLANK | ((1 << Config::ROW_BITS) - 1) << Config::ROW_BIT_0;
+    pio_sm_set_pins_with_mask(bitstream_pio, bitstream_sm, pins_to_set, pins_to_set);
+
+    // Break the chain between the channels, so neither restarts the other
+    dma_hw->ch[dma_ctrl_channel].al1_ctrl = (dma_hw->ch[dma_ctrl_channel].al1_ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (dma_ctrl_channel << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+    dma_hw->ch[dma_channel].al1_ctrl = (dma_hw->ch[dma_channel].al1_ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (dma_channel << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+
+    // Abort any in-progress DMA transfer
+    dma_safe_abort(dma_ctrl_channel);
+    dma_safe_abort(dma_channel);
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::release() {
+    if(active == this) {
+      dma_channel_unclaim(dma_ctrl_channel);
+      dma_channel_unclaim(dma_channel);
+      pio_sm_unclaim(bitstream_pio, bitstream_sm);
+      pio_remove_program(bitstream_pio, Config::program(), bitstream_sm_offset);
+
+      active = nullptr;
+    }
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::dma_safe_abort(uint channel) {
+    // Tear down the DMA channel.
+    // This is copied from: https://github.com/raspberrypi/pico-sdk/pull/744/commits/5e0e8004dd790f0155426e6689a66e08a83cd9fc
+    uint32_t irq0_save = dma_hw->inte0 & (1u << channel);
+    hw_clear_bits(&dma_hw->inte0, irq0_save);
+
+    dma_hw->abort = 1u << channel;
+
+    // To fence off on in-flight transfers, the BUSY bit should be polled
+    // rather than the ABORT bit, because the ABORT bit can clear prematurely.
+    while (dma_hw->ch[channel].ctrl_trig & DMA_CH0_CTRL_TRIG_BUSY_BITS) tight_loop_contents();
+
+    // Clear the interrupt (if any) and restore the interrupt masks.
+    dma_hw->ints0 = 1u << channel;
+    hw_set_bits(&dma_hw->inte0, irq0_save);
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::clear() {
+    if(active == this) {
+      // the back bitstream may still be on show until a pending swap
+      wait_for_swap();
+
+      // zero the pixels of every bcd frame of both bitstreams, leaving the
+      // headers alone, so the display goes dark straight away
+      auto blank = [](uint8_t *stream) {
+        for(uint32_t frame = 0; frame < ROW_COUNT * BCD_FRAME_COUNT; frame++) {
+          memset(&stream[frame * BCD_FRAME_BYTES + PIXEL_OFFSET], 0, COLUMNS);
+        }
+      };
+      blank(back_bitstream);
+      if(front_bitstream != back_bitstream) blank(front_bitstream);
+    }
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::build_luts() {
+    for(uint v = 0; v < 256; v++) {
+      lut[v] = gamma_lut[(v * brightness) >> 8];
+    }
+  }
+
+  // Four values of up to 16 bits, one per byte lane, split into a word of
+  // their low eight bits and a word of their high eight
+  template<typename Config>
+  inline void BCDMatrix<Config>::split_lanes(const uint16_t *v, uint32_t &lo, uint32_t &hi) {
+    uint32_t a = v[0] | v[2] << 16;
+    uint32_t b = v[1] | v[3] << 16;
+    lo = (a & 0x00ff00ff) | (b & 0x00ff00ff) << 8;
+    hi = (a >> 8 & 0x00ff00ff) | (b & 0xff00ff00);
+  }
+
+  // Writes a row's gamma corrected values, given for every byte up to
+  // ROW_DATA_BYTES, into all of its bcd frames. Four bytes are bit sliced at
+  // a time so each frame gets whole words rather than a byte per pixel
+  template<typename Config>
+  void BCDMatrix<Config>::write_row(uint32_t row, const uint16_t *r, const uint16_t *g, const uint16_t *b) {
+    uint32_t *frames = (uint32_t *)&back_bitstream[row * ROW_BYTES];
+    const uint32_t stride = BCD_FRAME_BYTES / 4;
+
+    // the row pixel count, and any header bytes before the pixels, share
+    // the first word with them
+    const uint32_t header = frames[0] & ((1u << (PIXEL_OFFSET * 8)) - 1);
+
+    for(uint32_t i = 0; i < ROW_DATA_WORDS; i++) {
+      uint32_t r_lo, r_hi, g_lo, g_hi, b_lo, b_hi;
+      split_lanes(&r[i * 4], r_lo, r_hi);
+      split_lanes(&g[i * 4], g_lo, g_hi);
+      split_lanes(&b[i * 4], b_lo, b_hi);
+      uint32_t keep = i == 0 ? header : 0;
+
+      uint32_t *p = &frames[i];
+      for(uint32_t frame = 0; frame < BCD_FRAME_COUNT; frame++) {
+        if(frame == 8) {
+          r_lo = r_hi;
+          g_lo = g_hi;
+          b_lo = b_hi;
+        }
+        *p = keep | (b_lo & 0x01010101) | (g_lo & 0x01010101) << 1 | (r_lo & 0x01010101) << 2;
+        r_lo >>= 1;
+        g_lo >>= 1;
+        b_lo >>= 1;
+        p += stride;
+      }
+    }
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b) {
+    if(x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+
+    wait_for_swap();
+
+    // find where the pixel is on the display, which shows each band of
+    // the canvas upside down and back to front
+    uint32_t band = y / ROW_COUNT;
+    uint32_t row = (band + 1) * ROW_COUNT - 1 - y;
+    uint32_t column = (band + 1) * WIDTH - 1 - x;
+
+    uint16_t gamma_r = lut[r];
+    uint16_t gamma_g = lut[g];
+    uint16_t gamma_b = lut[b];
+
+    // set the appropriate bits in the separate bcd frames
+    uint8_t *p = &back_bitstream[row * ROW_BYTES + PIXEL_OFFSET + column];
+    for(uint32_t frame = 0; frame < BCD_FRAME_COUNT; frame++) {
+      uint8_t red_bit = gamma_r & 0b1;
+      uint8_t green_bit = gamma_g & 0b1;
+      uint8_t blue_bit = gamma_b & 0b1;
+
+      *p = (blue_bit << 0) | (green_bit << 1) | (red_bit << 2);
+
+      gamma_r >>= 1;
+      gamma_g >>= 1;
+      gamma_b >>= 1;
+      p += BCD_FRAME_BYTES;
+    }
+  }
+
+  template<typename Config>
+  bool BCDMatrix<Config>::set_double_buffered(uint8_t *buffer) {
+    if(double_bitstream) return true;
+    if(buffer) {
+      double_bitstream = buffer;
+    } else {
+      double_bitstream = new uint8_t[BITSTREAM_LENGTH];
+      managed_double_bitstream = true;
+    }
+
+    // start with a copy, for the row selects and bcd tick counts
+    memcpy(double_bitstream, bitstream, BITSTREAM_LENGTH);
+    back_bitstream = double_bitstream;
+    return true;
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::swap_buffers() {
+    if(front_bitstream == back_bitstream) return;
+
+    // Only one swap can be waiting for the end of a pass
+    wait_for_swap();
+    std::swap(front_bitstream, back_bitstream);
+    bitstream_addr = (uint32_t)front_bitstream;
+  }
+
+  template<typename Config>
+  bool BCDMatrix<Config>::swap_pending() {
+    if(active != this || front_bitstream == back_bitstream) return false;
+
+    // The swap has happened once the dma is reading from the new front bitstream
+    uint32_t current = dma_hw->ch[dma_channel].read_addr;
+    uint32_t front = (uint32_t)front_bitstream;
+    return current <= front || current > front + BITSTREAM_LENGTH;
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::wait_for_swap() {
+    while(swap_pending()) {
+      tight_loop_contents();
+    }
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::set_brightness(float value) {
+    value = value < 0.0f ? 0.0f : value;
+    value = value > 1.0f ? 1.0f : value;
+    brightness = floor(value * 256.0f);
+    build_luts();
+  }
+
+  template<typename Config>
+  float BCDMatrix<Config>::get_brightness() {
+    return brightness / 255.0f;
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::adjust_brightness(float delta) {
+    set_brightness(get_brightness() + delta);
+  }
+
+  // puts canvas row y into the row data back to front, ending at last, as
+  // the display shows it
+  template<typename Config>
+  void BCDMatrix<Config>::convert_row(PicoGraphics *graphics, int y, uint32_t last, uint16_t *r, uint16_t *g, uint16_t *b, RGB888 *converted) {
+    if(graphics->pen_type == PicoGraphics::PEN_RGB565) {
+      const uint16_t *p = (const uint16_t *)graphics->frame_buffer + y * WIDTH;
+      for(int x = 0; x < WIDTH; x++) {
+        uint16_t col = __builtin_bswap16(p[x]);
+        r[last - x] = lut[(col & 0b1111100000000000) >> 8];
+        g[last - x] = lut[(col & 0b0000011111100000) >> 3];
+        b[last - x] = lut[(col & 0b0000000000011111) << 3];
+      }
+    }
+    else if(graphics->pen_type == PicoGraphics::PEN_RGB332) {
+      const uint8_t *p = (const uint8_t *)graphics->frame_buffer + y * WIDTH;
+      for(int x = 0; x < WIDTH; x++) {
+        uint8_t col = p[x];
+        r[last - x] = lut[(col & 0b11100000)];
+        g[last - x] = lut[(col & 0b00011100) << 3];
+        b[last - x] = lut[(col & 0b00000011) << 6];
+      }
+    }
+    else {
+      const RGB888 *p = (const RGB888 *)graphics->frame_buffer + y * WIDTH;
+      if(graphics->pen_type != PicoGraphics::PEN_RGB888) {
+        graphics->get_data(PicoGraphics::PEN_RGB888, y, converted);
+        p = converted;
+      }
+      for(int x = 0; x < WIDTH; x++) {
+        uint32_t col = p[x];
+        r[last - x] = lut[(col & 0xff0000) >> 16];
+        g[last - x] = lut[(col & 0x00ff00) >>  8];
+        b[last - x] = lut[(col & 0x0000ff) >>  0];
+      }
+    }
+  }
+
+  template<typename Config>
+  void BCDMatrix<Config>::update(PicoGraphics *graphics) {
+    if(active == this) {
+      // The last frame's back bitstream is still being shown until its swap
+      wait_for_swap();
+
+      if(graphics->pen_type != PicoGraphics::PEN_RGB888 && graphics->pen_type != PicoGraphics::PEN_RGB565
+      && graphics->pen_type != PicoGraphics::PEN_RGB332 && graphics->pen_type != PicoGraphics::PEN_P8
+      && graphics->pen_type != PicoGraphics::PEN_P4 && graphics->pen_type != PicoGraphics::PEN_COMPOSITOR) {
+        return;
+      }
+
+      // gamma corrected values for every byte of a row's data, the unused
+      // ones left at zero
+      uint16_t r[ROW_DATA_BYTES] = {0};
+      uint16_t g[ROW_DATA_BYTES] = {0};
+      uint16_t b[ROW_DATA_BYTES] = {0};
+      RGB888 converted[WIDTH];
+
+      // each row of the display shows a row from every band of the canvas
+      for(uint32_t row = 0; row < ROW_COUNT; row++) {
+        for(uint32_t band = 0; band < BANDS; band++) {
+          convert_row(graphics, (band + 1) * ROW_COUNT - 1 - row, PIXEL_OFFSET + (band + 1) * WIDTH - 1, r, g, b, converted);
+        }
+        write_row(row, r, g, b);
+      }
+
+      swap_buffers();
+    }
+  }
+
+}
@@ -87,8 +87,13 @@ namespace bitmap {
     // Offset our y position to account for our column canvas being 32 pixels
     int y_offset = y - (8 * scale);
 
+    // Transpose the glyph into rows of up to 32 columns so that it
+    // can be drawn as horizontal spans rather than individual pixels
+    uint32_t rows[32] = {0};
+    uint8_t width = font->widths[char_index];
+
     // Iterate through each horizontal column of font (and accent) data
-    for(uint8_t cx = 0; cx < font->widths[char_index]; cx++) {
+    for(uint8_t cx = 0; cx < width; cx++) {
       // Our maximum bitmap font height will be 16 pixels
       // give ourselves a 32 pixel high canvas in which to plot the char and accent.
       // We shift the char down 8 pixels to make room for an accent above.
@@ -106,17 +111,34 @@ namespace bitmap {
         data |= *a << accent_offset;
       }
 
-      // Draw the 32 pixel column
-      for(uint8_t cy = 0; cy < 32; cy++) {
-        if((1U << cy) & data) {
-          rectangle(x + (cx * scale), y_offset + (cy * scale), scale, scale);
-        }
+      // Scatter the set bits of this column into their rows
+      while(data) {
+        rows[__builtin_ctz(data)] |= 1U << cx;
+        data &= data - 1;
       }
 
       // Move to the next columns of char and accent data
       d++;
       a++;
     }
+
+    // Draw each run of set pixels in a row as a single rectangle, identical
+    // neighbouring rows (such as vertical stems) are merged into one taller rectangle
+    uint8_t cy = 0;
+    while(cy < 32) {
+      uint32_t row = rows[cy];
+      uint8_t h = 1;
+      while(cy + h < 32 && rows[cy + h] == row) h++;
+
+      while(row) {
+        uint8_t start = __builtin_ctz(row);
+        uint8_t length = __builtin_ctz(~(row >> start));
+        rectangle(x + (start * scale), y_offset + (cy * scale), length * scale, h * scale);
+        row &= ~(((1U << length) - 1) << start);
+      }
+
+      cy += h;
+    }
   }
 
   void text(const font_t *font, rect_func rectangle, const std::string &t, const int32_t x, const int32_t y, const int32_t wrap, const uint8_t scale, const uint8_t letter_spacing) {
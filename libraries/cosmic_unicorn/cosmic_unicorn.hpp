@@ -2,7 +2,9 @@
 
 #include "hardware/pio.h"
 #include "pico_graphics.hpp"
+#include "../bcd_matrix/bcd_matrix.hpp"
 #include "../pico_synth/pico_synth.hpp"
+#include "../lz_blocks/lz_blocks.hpp"
 
 namespace pimoroni {
 
@@ -46,42 +48,65 @@ namespace pimoroni {
     static const uint8_t SWITCH_BRIGHTNESS_DOWN = 26;
 
   private:
-    static const uint32_t ROW_COUNT = 16;
-    static const uint32_t BCD_FRAME_COUNT = 14;
-    static const uint32_t BCD_FRAME_BYTES = 72;
-    static const uint32_t ROW_BYTES = BCD_FRAME_COUNT * BCD_FRAME_BYTES;
-    static const uint32_t BITSTREAM_LENGTH = (ROW_COUNT * ROW_BYTES);
     static const uint SYSTEM_FREQ = 22050;
 
-  private:
-    static PIO bitstream_pio;
-    static uint bitstream_sm;
-    static uint bitstream_sm_offset;
+    // the display, as BCDMatrix drives it. Each of its 16 rows lights a
+    // row of the bottom half of the canvas and a row of the top half
+    struct Display {
+      static const int WIDTH = CosmicUnicorn::WIDTH;
+      static const int HEIGHT = CosmicUnicorn::HEIGHT;
+
+      static const uint32_t ROW_COUNT = 16;
+      static const uint32_t BCD_FRAME_COUNT = 14;
+      static const uint32_t BCD_FRAME_BYTES = 72;
+      static const uint32_t PIXEL_OFFSET = 1;
+      static const uint32_t ROW_SELECT_OFFSET = 68;
+      static const uint32_t BCD_TICKS_OFFSET = 69;
+
+      static const uint8_t COLUMN_CLOCK = CosmicUnicorn::COLUMN_CLOCK;
+      static const uint8_t COLUMN_DATA = CosmicUnicorn::COLUMN_DATA;
+      static const uint8_t COLUMN_LATCH = CosmicUnicorn::COLUMN_LATCH;
+      static const uint8_t COLUMN_BLANK = CosmicUnicorn::COLUMN_BLANK;
+      static const uint8_t ROW_BIT_0 = CosmicUnicorn::ROW_BIT_0;
+      static const uint8_t ROW_BITS = 4;
+
+      static const pio_program_t *program();
+      static pio_sm_config program_config(uint offset);
+    };
 
+  private:
     static PIO audio_pio;
     static uint audio_sm;
     static uint audio_sm_offset;
 
-    uint16_t brightness = 256;
     uint16_t volume = 127;
 
-    // must be aligned for 32bit dma transfer
-    alignas(4) uint8_t bitstream[BITSTREAM_LENGTH] = {0};
-    const uint32_t bitstream_addr = (uint32_t)bitstream;
+    BCDMatrix<Display> matrix;
+
     static CosmicUnicorn* unicorn;
     static void dma_complete();
 
     static const uint NUM_TONE_BUFFERS = 2;
-    static const uint TONE_BUFFER_SIZE = 4;
-    int16_t tone_buffers[NUM_TONE_BUFFERS][TONE_BUFFER_SIZE] = {0};
     uint current_buffer = 0;
 
+    // the synth renders a block of samples at a time into one buffer while
+    // the other plays, so the audio dma only interrupts every 11.6ms
+    static const uint TONE_BUFFER_SIZE = 256;
     PicoSynth synth;
 
+    // compressed samples are decoded a block at a time into one buffer
+    // while the other plays. The synth shares the same buffers
+    static const uint SAMPLE_BUFFER_SIZE = 512;
+    int16_t sample_buffers[NUM_TONE_BUFFERS][SAMPLE_BUFFER_SIZE] = {0};
+    uint32_t sample_lengths[NUM_TONE_BUFFERS] = {0};
+    LZBlocks compressed;
+    uint32_t next_block = 0;
+
     enum PlayMode {
       PLAYING_BUFFER,
       //PLAYING_TONE,
       PLAYING_SYNTH,
+      PLAYING_COMPRESSED,
       NOT_PLAYING
     };
     PlayMode play_mode = NOT_PLAYING;
@@ -106,20 +131,32 @@ namespace pimoroni {
 
     void set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b);
 
+    // give the display a second bitstream of bitstream_length() bytes, aligned
+    // for 32bit dma transfer, or from the heap if buffer is nullptr
+    bool set_double_buffered(uint8_t *buffer = nullptr);
+    static constexpr uint32_t bitstream_length() { return BCDMatrix<Display>::bitstream_length(); }
+    // show what's been drawn from the start of the next pass
+    void swap_buffers();
+    bool swap_pending();
+    void wait_for_swap();
+
     uint16_t light();
 
     bool is_pressed(uint8_t button);
 
     void play_sample(uint8_t *data, uint32_t length);
+    // play 16-bit samples packed by lz_pack.py with a block size of at
+    // most 1024 bytes, false if the data isn't valid
+    bool play_compressed_sample(const uint8_t *data, uint32_t length);
     void play_synth();
     void stop_playing();
     AudioChannel& synth_channel(uint channel);
 
   private:
     void partial_teardown();
-    void dma_safe_abort(uint channel);
     void next_audio_sequence();
     void populate_next_synth();
+    void populate_next_compressed();
   };
 
 }
\ No newline at end of file
@@ -1,3 +1,7 @@
+if(NOT TARGET bcd_matrix)
+    include(${CMAKE_CURRENT_LIST_DIR}/../bcd_matrix/bcd_matrix.cmake)
+endif()
+
 add_library(galactic_unicorn INTERFACE)
 
 pico_generate_pio_header(galactic_unicorn ${CMAKE_CURRENT_LIST_DIR}/galactic_unicorn.pio)
@@ -7,9 +11,10 @@ pico_generate_pio_header(galactic_unicorn ${CMAKE_CURRENT_LIST_DIR}/audio_i2s.pi
 target_sources(galactic_unicorn INTERFACE
   ${CMAKE_CURRENT_LIST_DIR}/galactic_unicorn.cpp
   ${CMAKE_CURRENT_LIST_DIR}/../pico_synth/pico_synth.cpp
+  ${CMAKE_CURRENT_LIST_DIR}/../lz_blocks/lz_blocks.cpp
 )
 
 target_include_directories(galactic_unicorn INTERFACE ${CMAKE_CURRENT_LIST_DIR})
 
 # Pull in pico libraries that we need
-target_link_libraries(galactic_unicorn INTERFACE pico_stdlib pico_graphics hardware_adc hardware_pio hardware_dma)
+target_link_libraries(galactic_unicorn INTERFACE pico_stdlib pico_graphics bcd_matrix hardware_adc hardware_pio hardware_dma)
@@ -0,0 +1,11 @@
+if(NOT TARGET pico_graphics)
+    include(${CMAKE_CURRENT_LIST_DIR}/../pico_graphics/pico_graphics.cmake)
+endif()
+
+add_library(gifdec
+    ${CMAKE_CURRENT_LIST_DIR}/gifdec.cpp
+)
+
+target_include_directories(gifdec INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+target_link_libraries(gifdec pico_graphics pico_stdlib)
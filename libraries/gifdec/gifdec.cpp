@@ -0,0 +1,494 @@
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+#include "gifdec.hpp"
+
+namespace pimoroni {
+
+  static const uint8_t BLOCK_EXTENSION = 0x21;
+  static const uint8_t BLOCK_IMAGE = 0x2c;
+  static const uint8_t BLOCK_TRAILER = 0x3b;
+
+  static const uint8_t EXTENSION_GRAPHIC_CONTROL = 0xf9;
+  static const uint8_t EXTENSION_APPLICATION = 0xff;
+
+  // interlaced rows come in four passes
+  static const uint8_t interlace_start[4] = {0, 4, 2, 1};
+  static const uint8_t interlace_step[4]  = {8, 8, 4, 2};
+
+  static inline uint16_t read_le16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+  }
+
+  // smallest rectangle covering both, either of which may be empty
+  static Rect bounds_of(const Rect &a, const Rect &b) {
+    if(a.empty()) return b;
+    if(b.empty()) return a;
+    int32_t x1 = std::min(a.x, b.x);
+    int32_t y1 = std::min(a.y, b.y);
+    int32_t x2 = std::max(a.x + a.w, b.x + b.w);
+    int32_t y2 = std::max(a.y + a.h, b.y + b.h);
+    return Rect(x1, y1, x2 - x1, y2 - y1);
+  }
+
+  // bytes per pixel of the surfaces we can save and restore areas of
+  static uint32_t pixel_bytes(const PicoGraphics *graphics) {
+    switch(graphics->pen_type) {
+      case PicoGraphics::PEN_RGB332:
+      case PicoGraphics::PEN_P8:
+        return 1;
+      case PicoGraphics::PEN_RGB565:
+        return 2;
+      case PicoGraphics::PEN_RGB888:
+        return 4;
+      default:
+        return 0;
+    }
+  }
+
+  int32_t GIFDecoder::fill() {
+    // memory sources are in the buffer from the start
+    if(!read) return 0;
+
+    int32_t n = read(buffer, INPUT_BUFFER_SIZE);
+    if(n < 0) {
+      read_failed = true;
+      n = 0;
+    }
+    in = buffer;
+    input_position = 0;
+    input_length = n;
+    source_position += n;
+    return n;
+  }
+
+  int GIFDecoder::read_byte() {
+    if(input_position == input_length && fill() == 0) return -1;
+    return in[input_position++];
+  }
+
+  bool GIFDecoder::read_bytes(uint8_t *dest, uint32_t length) {
+    while(length) {
+      if(input_position == input_length && fill() == 0) return false;
+      uint32_t n = std::min(length, uint32_t(input_length - input_position));
+      memcpy(dest, in + input_position, n);
+      input_position += n;
+      dest += n;
+      length -= n;
+    }
+    return true;
+  }
+
+  bool GIFDecoder::skip_bytes(uint32_t length) {
+    while(length) {
+      if(input_position == input_length && fill() == 0) return false;
+      uint32_t n = std::min(length, uint32_t(input_length - input_position));
+      input_position += n;
+      length -= n;
+    }
+    return true;
+  }
+
+  bool GIFDecoder::skip_sub_blocks() {
+    while(true) {
+      int length = read_byte();
+      if(length < 0) return false;
+      if(length == 0) return true;
+      if(!skip_bytes(length)) return false;
+    }
+  }
+
+  uint32_t GIFDecoder::position() const {
+    if(!read) return input_position;
+    return source_position - (input_length - input_position);
+  }
+
+  bool GIFDecoder::read_header() {
+    uint8_t header[13];
+    if(!read_bytes(header, 13)) return false;
+    if(memcmp(header, "GIF87a", 6) != 0 && memcmp(header, "GIF89a", 6) != 0) return false;
+
+    width = read_le16(header + 6);
+    height = read_le16(header + 8);
+    if(width == 0 || height == 0) return false;
+
+    uint8_t packed = header[10];
+    background = header[11];
+    global_size = packed & 0x80 ? 2 << (packed & 0b111) : 0;
+    if(global_size && !read_bytes(&global_table[0][0], global_size * 3)) return false;
+
+    first_frame = position();
+    return true;
+  }
+
+  bool GIFDecoder::open(const uint8_t *data, uint32_t length) {
+    read = nullptr;
+    seek = nullptr;
+    in = data;
+    input_position = 0;
+    input_length = length;
+    return reset();
+  }
+
+  bool GIFDecoder::open(read_func read, seek_func seek) {
+    this->read = read;
+    this->seek = seek;
+    in = buffer;
+    input_position = 0;
+    input_length = 0;
+    source_position = 0;
+    return reset();
+  }
+
+  bool GIFDecoder::reset() {
+    read_failed = false;
+    loops = 0;
+    have_previous = false;
+    saved.reset();
+    dirty_area = Rect();
+    current = frame_t{Rect(), 0, DISPOSE_NONE, -1, false};
+
+    // colour indices past the end of a table are drawn black
+    memset(global_table, 0, sizeof(global_table));
+
+    // the row buffers depend on the canvas width
+    row.reset();
+    span.reset();
+
+    header_read = read_header();
+    return header_read;
+  }
+
+  bool GIFDecoder::rewind() {
+    if(!header_read) return false;
+
+    // the first frame is drawn over whatever is there
+    have_previous = false;
+    saved.reset();
+
+    if(read) {
+      if(!seek || !seek(first_frame)) return false;
+      input_position = 0;
+      input_length = 0;
+      source_position = first_frame;
+    } else {
+      input_position = first_frame;
+    }
+    return true;
+  }
+
+  Rect GIFDecoder::dispose(PicoGraphics *graphics, uint8_t flags) {
+    if(!have_previous) return Rect();
+    have_previous = false;
+
+    const Rect &r = previous_area;
+
+    switch(previous.disposal) {
+      case DISPOSE_BACKGROUND:
+        if(flags & GIF_PALETTE_DIRECT) {
+          graphics->set_pen(background);
+        } else if(background < global_size) {
+          graphics->set_pen(global_table[background][0], global_table[background][1], global_table[background][2]);
+        } else {
+          graphics->set_pen(0, 0, 0);
+        }
+        graphics->rectangle(r);
+        return r;
+
+      case DISPOSE_PREVIOUS: {
+        if(!saved) return Rect();
+        uint32_t bpp = pixel_bytes(graphics);
+        uint8_t *src = saved.get();
+        for(auto y = 0; y < saved_area.h; y++) {
+          uint8_t *dst = (uint8_t *)graphics->frame_buffer + ((saved_area.y + y) * graphics->bounds.w + saved_area.x) * bpp;
+          memcpy(dst, src, saved_area.w * bpp);
+          src += saved_area.w * bpp;
+        }
+        saved.reset();
+        return saved_area;
+      }
+
+      default:
+        return Rect();
+    }
+  }
+
+  void GIFDecoder::save(PicoGraphics *graphics, const Rect &r) {
+    // without a copy the frame is left in place
+    uint32_t bpp = pixel_bytes(graphics);
+    if(!bpp || r.empty()) return;
+
+    saved.reset(new (std::nothrow) uint8_t[r.w * r.h * bpp]);
+    if(!saved) return;
+
+    saved_area = r;
+    uint8_t *dst = saved.get();
+    for(auto y = 0; y < r.h; y++) {
+      const uint8_t *src = (const uint8_t *)graphics->frame_buffer + ((r.y + y) * graphics->bounds.w + r.x) * bpp;
+      memcpy(dst, src, r.w * bpp);
+      dst += r.w * bpp;
+    }
+  }
+
+  void GIFDecoder::draw_row(PicoGraphics *graphics, const Point &p, int32_t y, int32_t count, uint8_t flags) {
+    const Rect &clip = graphics->clip;
+    const Rect &area = current.area;
+
+    y += area.y;
+    int32_t sy = p.y + y;
+    if(y < 0 || y >= height || sy < clip.y || sy >= clip.y + clip.h) return;
+
+    // the part of the row on the canvas and inside the clip rectangle
+    int32_t first = std::max(std::max<int32_t>(0, -area.x), clip.x - p.x - area.x);
+    int32_t last = std::min(std::min(count, width - area.x), clip.x + clip.w - p.x - area.x);
+
+    int32_t transparent = current.transparent;
+    bool dither = !(flags & GIF_NO_DITHER);
+    bool direct = flags & GIF_PALETTE_DIRECT;
+    const uint8_t *indices = row.get();
+
+    int32_t i = first;
+    while(i < last) {
+      // find the next run of opaque pixels
+      while(i < last && indices[i] == transparent) i++;
+      int32_t start = i;
+      while(i < last && indices[i] != transparent) i++;
+      if(start == i) break;
+
+      Point pt(p.x + area.x + start, sy);
+      uint32_t length = i - start;
+
+      if(direct) {
+        for(auto j = start; j < i; j++, pt.x++) {
+          graphics->set_pen(indices[j]);
+          graphics->set_pixel(pt);
+        }
+      } else if(graphics->pen_type == PicoGraphics::PEN_RGB888) {
+        RGB888 *dst = (RGB888 *)graphics->frame_buffer + pt.y * graphics->bounds.w + pt.x;
+        for(auto j = start; j < i; j++) {
+          const uint8_t *c = table[indices[j]];
+          *dst++ = (c[0] << 16) | (c[1] << 8) | c[2];
+        }
+      } else {
+        RGB565 *dst = span.get();
+        for(auto j = start; j < i; j++) *dst++ = pens[indices[j]];
+        graphics->set_pixel_span_rgb565(pt, length, span.get(), dither);
+      }
+    }
+  }
+
+  GIFDecoder::Result GIFDecoder::decode_image(PicoGraphics *graphics, const Point &p, uint8_t flags) {
+    uint8_t descriptor[9];
+    if(!read_bytes(descriptor, 9)) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+
+    Rect &area = current.area;
+    area = Rect(read_le16(descriptor), read_le16(descriptor + 2), read_le16(descriptor + 4), read_le16(descriptor + 6));
+    uint8_t packed = descriptor[8];
+    current.interlaced = packed & 0x40;
+
+    if(packed & 0x80) {
+      table_size = 2 << (packed & 0b111);
+      memset(local_table, 0, sizeof(local_table));
+      if(!read_bytes(&local_table[0][0], table_size * 3)) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+      table = local_table;
+    } else {
+      table_size = 256;
+      table = global_table;
+    }
+
+    int min_code_size = read_byte();
+    if(min_code_size < 1 || min_code_size > 11) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+
+    // put back whatever the last frame asked for, then keep a copy of what
+    // this one covers if it'll need putting back too
+    Rect disposed = dispose(graphics, flags);
+    Rect visible = Rect(p.x + area.x, p.y + area.y, area.w, area.h)
+      .intersection(Rect(p.x, p.y, width, height))
+      .intersection(graphics->clip);
+    if(current.disposal == DISPOSE_PREVIOUS) save(graphics, visible);
+    dirty_area = bounds_of(disposed, visible);
+
+    if(!(flags & GIF_PALETTE_DIRECT)) {
+      for(auto i = 0u; i < 256; i++) {
+        pens[i] = RGB(table[i][0], table[i][1], table[i][2]).to_rgb565();
+      }
+    }
+
+    // LZW decode straight out of the data sub-blocks
+    lzw_t &t = *lzw;
+    const uint32_t clear = 1u << min_code_size;
+    const uint32_t end = clear + 1;
+    uint32_t code_size = min_code_size + 1;
+    uint32_t next = end + 1;
+    int32_t old = -1;
+    uint8_t first = 0;
+
+    for(auto i = 0u; i < clear; i++) t.suffix[i] = i;
+
+    uint32_t bits = 0;
+    uint32_t bit_count = 0;
+    uint32_t block_remaining = 0;
+    bool blocks_done = false;
+
+    int32_t x = 0, y = 0, pass = 0;
+    uint32_t pixels_left = area.w * area.h;
+    uint8_t *indices = row.get();
+    int32_t row_limit = std::max<int32_t>(0, std::min(area.w, width - area.x));
+
+    while(pixels_left) {
+      // fetch the next code, running out of data ends the frame early
+      while(bit_count < code_size) {
+        if(block_remaining == 0) {
+          int length = read_byte();
+          if(length <= 0) {
+            blocks_done = true;
+            break;
+          }
+          block_remaining = length;
+        }
+        int b = read_byte();
+        if(b < 0) {
+          blocks_done = true;
+          break;
+        }
+        block_remaining--;
+        bits |= uint32_t(b) << bit_count;
+        bit_count += 8;
+      }
+      if(bit_count < code_size) break;
+
+      uint32_t code = bits & ((1u << code_size) - 1);
+      bits >>= code_size;
+      bit_count -= code_size;
+
+      if(code == clear) {
+        code_size = min_code_size + 1;
+        next = end + 1;
+        old = -1;
+        continue;
+      }
+      if(code == end) break;
+
+      // walk the string back to its first character on the stack
+      uint32_t sp = 0;
+      uint32_t c;
+      if(code < next && (old >= 0 || code < clear)) {
+        c = code;
+      } else if(code == next && old >= 0) {
+        t.stack[sp++] = first;
+        c = old;
+      } else {
+        return GIF_INVALID_FILE;
+      }
+      while(c > end) {
+        t.stack[sp++] = t.suffix[c];
+        c = t.prefix[c];
+      }
+      first = c;
+      t.stack[sp++] = first;
+
+      if(old >= 0 && next < MAX_CODES) {
+        t.prefix[next] = old;
+        t.suffix[next] = first;
+        next++;
+        if(next == (1u << code_size) && code_size < 12) code_size++;
+      }
+      old = code;
+
+      while(sp && pixels_left) {
+        uint8_t index = t.stack[--sp];
+        if(x < row_limit) indices[x] = index;
+        pixels_left--;
+        if(++x == area.w) {
+          draw_row(graphics, p, y, row_limit, flags);
+          x = 0;
+          if(!current.interlaced) {
+            y++;
+          } else {
+            y += interlace_step[pass];
+            while(y >= area.h && pass < 3) {
+              pass++;
+              y = interlace_start[pass];
+            }
+          }
+        }
+      }
+    }
+
+    // draw what we have of a row cut short
+    if(x) draw_row(graphics, p, y, std::min(x, row_limit), flags);
+
+    previous = current;
+    previous_area = visible;
+    have_previous = true;
+
+    // skip the rest of the data, including the block terminator
+    if(!blocks_done && !(skip_bytes(block_remaining) && skip_sub_blocks())) {
+      return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+    }
+
+    return GIF_OK;
+  }
+
+  GIFDecoder::Result GIFDecoder::next_frame(PicoGraphics *graphics, const Point &p, uint8_t flags) {
+    if(!header_read) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+
+    if(!lzw) lzw.reset(new (std::nothrow) lzw_t);
+    if(!row) row.reset(new (std::nothrow) uint8_t[width]);
+    if(!span) span.reset(new (std::nothrow) RGB565[width]);
+    if(!lzw || !row || !span) return GIF_NO_MEMORY;
+
+    // a graphic control extension only applies to the image after it
+    current.delay = 0;
+    current.disposal = DISPOSE_NONE;
+    current.transparent = -1;
+
+    while(true) {
+      int block = read_byte();
+
+      // plenty of files in the wild are missing their trailer
+      if(block < 0) return read_failed ? GIF_READ_ERROR : GIF_END;
+
+      switch(block) {
+        case BLOCK_TRAILER:
+          return GIF_END;
+
+        case BLOCK_IMAGE:
+          return decode_image(graphics, p, flags);
+
+        case BLOCK_EXTENSION: {
+          int label = read_byte();
+          int length = read_byte();
+          if(length < 0) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+
+          uint8_t data[255];
+          if(!read_bytes(data, length)) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+
+          if(label == EXTENSION_GRAPHIC_CONTROL && length >= 4) {
+            current.disposal = (data[0] >> 2) & 0b111;
+            if(current.disposal > DISPOSE_PREVIOUS) current.disposal = DISPOSE_NONE;
+            current.delay = read_le16(data + 1) * 10;
+            current.transparent = data[0] & 1 ? data[3] : -1;
+          } else if(label == EXTENSION_APPLICATION && length == 11 &&
+                    (memcmp(data, "NETSCAPE2.0", 11) == 0 || memcmp(data, "ANIMEXTS1.0", 11) == 0)) {
+            // the loop count is in the first sub-block
+            length = read_byte();
+            if(length < 0) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+            if(length == 0) break;
+            if(!read_bytes(data, length)) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+            if(length >= 3 && data[0] == 1) loops = read_le16(data + 1);
+          }
+
+          if(!skip_sub_blocks()) return read_failed ? GIF_READ_ERROR : GIF_INVALID_FILE;
+          break;
+        }
+
+        default:
+          return GIF_INVALID_FILE;
+      }
+    }
+  }
+
+}
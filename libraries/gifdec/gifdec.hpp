@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+// Streaming animated GIF decoder
+//
+// Frames are read a byte at a time from memory or a read callback and their
+// LZW data decoded straight onto a PicoGraphics surface a row at a time.
+// Only the frame's own sub-rectangle is touched, and the previous frame's
+// disposal method is applied first, so the cost of each frame scales with
+// the area that changed rather than the size of the canvas. The changed
+// area is available as dirty() for partial display updates.
+//
+// Memory use is fixed at 16KB for the LZW tables plus a few bytes per pixel
+// of canvas width. Frames that restore the previous image also need a copy
+// of the area they cover, which is only supported for 8, 16 and 32-bit
+// pens (RGB332, P8, RGB565 and RGB888).
+//
+//   GIFDecoder gif;
+//   gif.open(data, length);
+//   while(true) {
+//     if(gif.next_frame(&graphics, {0, 0}) == GIFDecoder::GIF_END) {
+//       gif.rewind();
+//       continue;
+//     }
+//     display.update(&graphics);
+//     sleep_ms(gif.frame().delay);
+//   }
+namespace pimoroni {
+
+  class GIFDecoder {
+  public:
+    enum Result : int8_t {
+      GIF_OK = 0,
+      GIF_END,            // no more frames, rewind() to loop
+      GIF_INVALID_FILE,   // not a GIF, or a truncated/corrupt one
+      GIF_READ_ERROR,
+      GIF_NO_MEMORY,
+    };
+
+    enum Flags : uint8_t {
+      // colour indices are drawn as pen numbers, for P4/P8 buffers whose
+      // palette has been set up to match the image
+      GIF_PALETTE_DIRECT = 1,
+      // pick the closest palette colour instead of dithering on P4/P8/3Bit/Inky7
+      GIF_NO_DITHER = 2,
+    };
+
+    enum Disposal : uint8_t {
+      DISPOSE_NONE = 0,       // leave the frame in place
+      DISPOSE_KEEP = 1,
+      DISPOSE_BACKGROUND = 2, // fill the frame's area with the background colour
+      DISPOSE_PREVIOUS = 3,   // put back what was there before the frame
+    };
+
+    struct frame_t {
+      Rect area;              // on the canvas
+      uint16_t delay;         // in milliseconds, 0 if not given
+      uint8_t disposal;
+      int16_t transparent;    // colour index, or -1 if none
+      bool interlaced;
+    };
+
+    // fill buffer with up to length bytes, returning the number read or -1 on error
+    typedef std::function<int32_t(uint8_t *buffer, int32_t length)> read_func;
+    // move the read position to offset from the start of the file
+    typedef std::function<bool(uint32_t offset)> seek_func;
+
+    static const int32_t INPUT_BUFFER_SIZE = 512;
+    static const uint32_t MAX_CODES = 4096;
+
+  private:
+    read_func read;
+    seek_func seek;
+
+    // memory sources are read in place, anything else through the buffer
+    const uint8_t *in = nullptr;
+    uint8_t buffer[INPUT_BUFFER_SIZE];
+    int32_t input_position = 0;
+    int32_t input_length = 0;
+    uint32_t source_position = 0;  // offset of the end of the buffer in the source
+    bool read_failed = false;
+
+    // logical screen
+    int32_t width = 0;
+    int32_t height = 0;
+    uint8_t background = 0;
+    uint16_t loops = 0;
+    uint16_t global_size = 0;
+    uint8_t global_table[256][3];
+    uint32_t first_frame = 0;      // offset to rewind to
+    bool header_read = false;
+
+    // the frame being decoded and the colour table it uses
+    frame_t current;
+    uint8_t local_table[256][3];
+    const uint8_t (*table)[3];
+    uint16_t table_size = 0;
+    RGB565 pens[256];
+
+    // the last frame drawn, where it landed on the surface and what to do
+    // with it before the next
+    frame_t previous;
+    Rect previous_area;
+    bool have_previous = false;
+    std::unique_ptr<uint8_t[]> saved;
+    Rect saved_area;
+
+    Rect dirty_area;
+
+    // LZW string table and output stack
+    struct lzw_t {
+      uint16_t prefix[MAX_CODES];
+      uint8_t suffix[MAX_CODES];
+      uint8_t stack[MAX_CODES];
+    };
+    std::unique_ptr<lzw_t> lzw;
+
+    // one row of colour indices and its converted pixels
+    std::unique_ptr<uint8_t[]> row;
+    std::unique_ptr<RGB565[]> span;
+
+    int32_t fill();
+    int read_byte();
+    bool read_bytes(uint8_t *buffer, uint32_t length);
+    bool skip_bytes(uint32_t length);
+    bool skip_sub_blocks();
+    uint32_t position() const;
+    bool read_header();
+    bool reset();
+
+    Rect dispose(PicoGraphics *graphics, uint8_t flags);
+    void save(PicoGraphics *graphics, const Rect &r);
+    void draw_row(PicoGraphics *graphics, const Point &p, int32_t y, int32_t count, uint8_t flags);
+    Result decode_image(PicoGraphics *graphics, const Point &p, uint8_t flags);
+
+  public:
+    bool open(const uint8_t *data, uint32_t length);
+    // a seek function is only needed to rewind() streamed files
+    bool open(read_func read, seek_func seek = nullptr);
+
+    int32_t get_width() const {return width;}
+    int32_t get_height() const {return height;}
+    // times to play the animation, 0 for forever
+    uint16_t get_loop_count() const {return loops;}
+
+    // draw the next frame with the top left of the canvas at p, respecting
+    // the clip rectangle
+    Result next_frame(PicoGraphics *graphics, const Point &p, uint8_t flags = 0);
+
+    // the frame last drawn by next_frame()
+    const frame_t &frame() const {return current;}
+
+    // the area of the surface changed by the last frame, including the
+    // previous frame's disposal, clipped to the clip rectangle
+    const Rect &dirty() const {return dirty_area;}
+
+    // go back to the first frame, false if the source can't seek. The last
+    // frame's disposal is dropped, so clear the canvas first to loop the way
+    // browsers do
+    bool rewind();
+  };
+
+}
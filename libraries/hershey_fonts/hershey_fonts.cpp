@@ -1,6 +1,7 @@
 #include "hershey_fonts.hpp"
 #include "common/unicode_sorta.hpp"
 #include <cmath>
+#include <algorithm>
 
 namespace hershey {
   std::map<std::string, const font_t*> fonts = {
@@ -49,7 +50,38 @@ namespace hershey {
     return width;
   }
 
+  transform_t transform(float s, float a) {
+    // vertices are within +/-128, so 128 * sqrt(2) * MAX_SCALE in 16.16
+    // still fits an int32_t whatever the angle
+    s = std::max(-MAX_SCALE, std::min(s, MAX_SCALE));
+    a = deg2rad(a);
+    float as = sinf(a);
+    float ac = cosf(a);
+
+    return {
+      int32_t(s * 65536.0f),
+      int32_t(s * ac * 65536.0f),
+      int32_t(s * as * 65536.0f),
+      int32_t(ac * 65536.0f),
+      int32_t(as * 65536.0f)
+    };
+  }
+
+  // Turn a list of strokes back into individual line segments
+  static stroke_func segments(line_func line) {
+    return [line](const int32_t *points, uint32_t count) {
+      for(uint32_t i = 1; i < count; i++) {
+        line(points[0], points[1], points[2], points[3]);
+        points += 2;
+      }
+    };
+  }
+
   int32_t glyph(const font_t* font, line_func line, unsigned char c, int32_t x, int32_t y, float s, float a) {
+    return glyph_strokes(font, segments(line), c, x, y, transform(s, a));
+  }
+
+  int32_t glyph_strokes(const font_t* font, stroke_func stroke, unsigned char c, int32_t x, int32_t y, const transform_t &t) {
     const font_glyph_t *gd = glyph_data(font, c);
 
     // if glyph data not found (id too great) then skip
@@ -57,56 +89,57 @@ namespace hershey {
       return 0;
     }
 
-    a = deg2rad(a);
-    float as = sin(a);
-    float ac = cos(a);
+    // transformed vertices of the current pen down stroke, these are
+    // passed on in batches rather than as individual line segments
+    const uint32_t MAX_POINTS = 32;
+    int32_t points[MAX_POINTS * 2];
+    uint32_t count = 0;
 
     const int8_t *pv = gd->vertices;
-    int8_t cx = (*pv++) * s;
-    int8_t cy = (*pv++) * s;
-    bool pen_down = true;
-
-    for(uint32_t i = 1; i < gd->vertex_count; i++) {
-      if(pv[0] == -128 && pv[1] == -128) {
-        pen_down = false;
-        pv += 2;
-      }else{
-        int8_t nx = (*pv++) * s;
-        int8_t ny = (*pv++) * s;
-
-        int rcx = (cx * ac - cy * as) + 0.5f;
-        int rcy = (cx * as + cy * ac) + 0.5f;
-
-        int rnx = (nx * ac - ny * as) + 0.5f;
-        int rny = (nx * as + ny * ac) + 0.5f;
-
-        if(pen_down) {
-          line(rcx + x, rcy + y, rnx + x, rny + y);
-        }
-
-        cx = nx;
-        cy = ny;
-        pen_down = true;
+
+    for(uint32_t i = 0; i < gd->vertex_count; i++) {
+      int32_t vx = *pv++;
+      int32_t vy = *pv++;
+
+      if(vx == -128 && vy == -128) {
+        // pen up, finish the current stroke
+        if(count > 1) stroke(points, count);
+        count = 0;
+        continue;
+      }
+
+      if(count == MAX_POINTS) {
+        // buffer full, draw what we have and carry on from the last point
+        stroke(points, count);
+        points[0] = points[(count - 1) * 2];
+        points[1] = points[(count - 1) * 2 + 1];
+        count = 1;
       }
+
+      points[count * 2]     = x + ((vx * t.cos_s - vy * t.sin_s + 0x8000) >> 16);
+      points[count * 2 + 1] = y + ((vx * t.sin_s + vy * t.cos_s + 0x8000) >> 16);
+      count++;
     }
 
-    return gd->width * s;
+    if(count > 1) stroke(points, count);
+
+    return (gd->width * t.scale) >> 16;
   }
 
   void text(const font_t* font, line_func line, std::string message, int32_t x, int32_t y, float s, float a) {
-    int32_t cx = x;
-    int32_t cy = y;
+    text_strokes(font, segments(line), message, x, y, s, a);
+  }
 
-    int32_t ox = 0;
+  void text_strokes(const font_t* font, stroke_func stroke, const std::string &message, int32_t x, int32_t y, float s, float a) {
+    transform_t t = transform(s, a);
 
-    float as = sin(deg2rad(a));
-    float ac = cos(deg2rad(a));
+    int32_t ox = 0;
 
     for(auto &c : message) {
-      int rcx = (ox * ac) + 0.5f;
-      int rcy = (ox * as) + 0.5f;
+      int32_t rcx = ((int64_t)ox * t.cos_a + 0x8000) >> 16;
+      int32_t rcy = ((int64_t)ox * t.sin_a + 0x8000) >> 16;
 
-      ox += glyph(font, line, c, cx + rcx, cy + rcy, s, a);
+      ox += glyph_strokes(font, stroke, c, x + rcx, y + rcy, t);
     }
   }
-}
\ No newline at end of file
+}
@@ -13,6 +13,9 @@ namespace hershey {
     font_glyph_t chars[95];
   };
 
+  // nominal height of the glyph coordinate space, used to space lines of text
+  const int32_t line_height = 32;
+
   extern const int8_t futural_vertices[2442];
   extern const font_t futural;
 
@@ -38,6 +41,21 @@ namespace hershey {
   extern const font_t timesrb;
 
   typedef std::function<void(int32_t x1, int32_t y1, int32_t x2, int32_t y2)> line_func;
+  typedef std::function<void(const int32_t *points, uint32_t count)> stroke_func;
+
+  // Largest scale the 16.16 transform can rotate a glyph by without
+  // overflowing 32 bits, larger scales are clamped to it
+  const float MAX_SCALE = 180.0f;
+
+  // Scale and rotation folded into 16.16 fixed point, computed once per string
+  // rather than once per glyph
+  struct transform_t {
+    int32_t scale;
+    int32_t cos_s;   // scale * cos(a)
+    int32_t sin_s;   // scale * sin(a)
+    int32_t cos_a;
+    int32_t sin_a;
+  };
 
   extern std::map<std::string, const font_t*> fonts;
 
@@ -45,6 +63,9 @@ namespace hershey {
   const font_glyph_t* glyph_data(const font_t* font, unsigned char c);
   int32_t measure_glyph(const font_t* font, unsigned char c, float s);
   int32_t measure_text(const font_t* font, std::string message, float s);
+  transform_t transform(float s, float a);
   int32_t glyph(const font_t* font, line_func line, unsigned char c, int32_t x, int32_t y, float s, float a);
+  int32_t glyph_strokes(const font_t* font, stroke_func stroke, unsigned char c, int32_t x, int32_t y, const transform_t &t);
   void text(const font_t* font, line_func line, std::string message, int32_t x, int32_t y, float s, float a);
+  void text_strokes(const font_t* font, stroke_func stroke, const std::string &message, int32_t x, int32_t y, float s, float a);
 }
\ No newline at end of file
@@ -45,6 +45,11 @@ void JPEGDEC::setMaxOutputSize(int iMaxMCUs)
         iMaxMCUs = 1; // don't allow invalid value
     _jpeg.iMaxMCUs = iMaxMCUs;
 } /* setMaxOutputSize() */
+
+void JPEGDEC::setCropArea(int x, int y, int cx, int cy)
+{
+    JPEGSetCropArea(&_jpeg, x, y, cx, cy);
+} /* setCropArea() */
 //
 // Memory initialization
 //
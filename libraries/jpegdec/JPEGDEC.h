@@ -179,6 +179,7 @@ typedef struct jpeg_image_tag
     int iVLCSize; // current quantity of data in the VLC buffer
     int iResInterval, iResCount; // restart interval
     int iMaxMCUs; // max MCUs of pixels per JPEGDraw call
+    int iCropX, iCropY, iCropCX, iCropCY; // area of the output to draw, none if 0 size
     JPEG_READ_CALLBACK *pfnRead;
     JPEG_SEEK_CALLBACK *pfnSeek;
     JPEG_DRAW_CALLBACK *pfnDraw;
@@ -230,6 +231,7 @@ class JPEGDEC
     int getLastError();
     void setPixelType(int iType); // defaults to little endian
     void setMaxOutputSize(int iMaxMCUs);
+    void setCropArea(int x, int y, int cx, int cy); // in output pixels, call after opening
 
   private:
     JPEGIMAGE _jpeg;
@@ -253,6 +255,7 @@ int JPEG_getThumbHeight(JPEGIMAGE *pJPEG);
 int JPEG_getLastError(JPEGIMAGE *pJPEG);
 void JPEG_setPixelType(JPEGIMAGE *pJPEG, int iType); // defaults to little endian
 void JPEG_setMaxOutputSize(JPEGIMAGE *pJPEG, int iMaxMCUs);
+void JPEG_setCropArea(JPEGIMAGE *pJPEG, int x, int y, int cx, int cy);
 #endif // __cplusplus
 
 // Due to unaligned memory causing an exception, we have to do these macros the slow way
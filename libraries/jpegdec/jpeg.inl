@@ -31,6 +31,7 @@ static int JPEGInit(JPEGIMAGE *pJPEG);
 static int JPEGParseInfo(JPEGIMAGE *pPage, int bExtractThumb);
 static void JPEGGetMoreData(JPEGIMAGE *pPage);
 static int DecodeJPEG(JPEGIMAGE *pImage);
+static void JPEGSetCropArea(JPEGIMAGE *pJPEG, int x, int y, int cx, int cy);
 static int32_t readRAM(JPEGFILE *pFile, uint8_t *pBuf, int32_t iLen);
 static int32_t seekMem(JPEGFILE *pFile, int32_t iPosition);
 #if defined (__MACH__) || defined( __LINUX__ ) || defined( __MCUXPRESSO )
@@ -570,6 +571,10 @@ void JPEG_setMaxOutputSize(JPEGIMAGE *pJPEG, int iMaxMCUs)
         iMaxMCUs = 1; // don't allow invalid value
     pJPEG->iMaxMCUs = iMaxMCUs;
 } /* JPEG_setMaxOutputSize() */
+void JPEG_setCropArea(JPEGIMAGE *pJPEG, int x, int y, int cx, int cy)
+{
+    JPEGSetCropArea(pJPEG, x, y, cx, cy);
+} /* JPEG_setCropArea() */
 
 int JPEG_decode(JPEGIMAGE *pJPEG, int x, int y, int iOptions)
 {
@@ -1997,7 +2002,7 @@ static void JPEGPutMCU8BitGray(JPEGIMAGE *pJPEG, int x, int iPitch)
     if (pJPEG->pDitherBuffer)
         pDest = &pJPEG->pDitherBuffer[x];
     else
-        pDest = (uint8_t *)&pJPEG->usPixels[x/2];
+        pDest = (uint8_t *)pJPEG->usPixels + x; // 1/8 scale MCUs can be 1 pixel wide
     
     if (pJPEG->ucSubSample <= 0x11) // single Y 
     {
@@ -3176,6 +3181,25 @@ uint8_t pixelmask=0, shift=0;
 // Decode the image
 // returns 0 for error, 1 for success
 //
+//
+// Limit drawing to an area of the (scaled) output image, a zero size
+// draws everything
+//
+static void JPEGSetCropArea(JPEGIMAGE *pJPEG, int x, int y, int cx, int cy)
+{
+    if (x < 0) { cx += x; x = 0; }
+    if (y < 0) { cy += y; y = 0; }
+    if (cx <= 0 || cy <= 0) // nothing left, draw nothing rather than everything
+    {
+        x = y = 0x7fff;
+        cx = cy = 1;
+    }
+    pJPEG->iCropX = x;
+    pJPEG->iCropY = y;
+    pJPEG->iCropCX = cx;
+    pJPEG->iCropCY = cy;
+} /* JPEGSetCropArea() */
+
 static int DecodeJPEG(JPEGIMAGE *pJPEG)
 {
     int cx, cy, x, y, mcuCX, mcuCY;
@@ -3189,6 +3213,7 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG)
     unsigned char cDCTable0, cACTable0, cDCTable1, cACTable1, cDCTable2, cACTable2;
     JPEGDRAW jd;
     int iMaxFill = 16, iScaleShift = 0;
+    int iCropX0, iCropX1, iCropY0, iCropY1;
 
     // Requested the Exif thumbnail
     if (pJPEG->iOptions & JPEG_EXIF_THUMBNAIL)
@@ -3272,6 +3297,29 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG)
     // Scale down the MCUs by the requested amount
     mcuCX >>= iScaleShift;
     mcuCY >>= iScaleShift;
+
+    // Only the MCUs overlapping the crop area are converted and drawn, the
+    // rest are entropy decoded to keep the bitstream in step and decoding
+    // stops after the last row of MCUs in the crop area
+    iCropX0 = iCropY0 = 0;
+    iCropX1 = cx;
+    iCropY1 = cy;
+    if (pJPEG->iCropCX > 0 && pJPEG->iCropCY > 0)
+    {
+        if (pJPEG->ucPixelType <= EIGHT_BIT_GRAYSCALE) // dithering works on whole rows
+        {
+            iCropX0 = pJPEG->iCropX / mcuCX;
+            iCropX1 = (pJPEG->iCropX + pJPEG->iCropCX + mcuCX - 1) / mcuCX;
+            if (iCropX1 > cx)
+                iCropX1 = cx;
+        }
+        iCropY0 = pJPEG->iCropY / mcuCY;
+        iCropY1 = (pJPEG->iCropY + pJPEG->iCropCY + mcuCY - 1) / mcuCY;
+        if (iCropY1 > cy)
+            iCropY1 = cy;
+        if (iCropX0 >= iCropX1 || iCropY0 >= iCropY1)
+            return 1; // nothing to draw
+    }
     
     iQuant1 = pJPEG->sQuantTable[pJPEG->JPCI[0].quant_tbl_no*DCTSIZE]; // DC quant values
     iQuant2 = pJPEG->sQuantTable[pJPEG->JPCI[1].quant_tbl_no*DCTSIZE];
@@ -3289,6 +3337,8 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG)
         iMCUCount *= 2; // each pixel is only 1 byte
     if (iMCUCount > cx)
         iMCUCount = cx; // don't go wider than the image
+    if (iMCUCount > iCropX1 - iCropX0)
+        iMCUCount = iCropX1 - iCropX0; // or the crop area
     if (iMCUCount > pJPEG->iMaxMCUs) // did the user set an upper bound on how many pixels per JPEGDraw callback?
         iMCUCount = pJPEG->iMaxMCUs;
     if (pJPEG->ucPixelType > EIGHT_BIT_GRAYSCALE) // dithered, override the max MCU count
@@ -3315,15 +3365,38 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG)
         jd.pPixels = pJPEG->usPixels;
     jd.iHeight = mcuCY;
     jd.y = pJPEG->iYOffset;
-    for (y = 0; y < cy && bContinue && iErr == 0; y++, jd.y += mcuCY)
+    for (y = 0; y < iCropY1 && bContinue && iErr == 0; y++, jd.y += mcuCY)
     {
-        jd.x = pJPEG->iXOffset;
+        jd.x = pJPEG->iXOffset + iCropX0 * mcuCX;
         xoff = 0; // start of new LCD output group
         iPitch = iMCUCount * mcuCX; // pixels per line of LCD buffer
         for (x = 0; x < cx && bContinue && iErr == 0; x++)
         {
             pJPEG->ucACTable = cACTable0;
             pJPEG->ucDCTable = cDCTable0;
+            if (y < iCropY0 || x < iCropX0 || x >= iCropX1) // outside the crop area
+            {
+                if (y == iCropY1 - 1 && x >= iCropX1)
+                    break; // nothing more to draw
+                iErr = JPEGDecodeMCU(pJPEG, iLum0, &iDCPred0);
+                if (pJPEG->ucSubSample > 0x11)
+                    iErr |= JPEGDecodeMCU(pJPEG, iLum1, &iDCPred0);
+                if (pJPEG->ucSubSample == 0x22)
+                {
+                    iErr |= JPEGDecodeMCU(pJPEG, iLum2, &iDCPred0);
+                    iErr |= JPEGDecodeMCU(pJPEG, iLum3, &iDCPred0);
+                }
+                if (pJPEG->ucSubSample && pJPEG->ucNumComponents == 3)
+                {
+                    pJPEG->ucACTable = cACTable1;
+                    pJPEG->ucDCTable = cDCTable1;
+                    iErr |= JPEGDecodeMCU(pJPEG, iCr, &iDCPred1);
+                    pJPEG->ucACTable = cACTable2;
+                    pJPEG->ucDCTable = cDCTable2;
+                    iErr |= JPEGDecodeMCU(pJPEG, iCb, &iDCPred2);
+                }
+                goto next_mcu;
+            }
             // do the first luminance component
             iErr = JPEGDecodeMCU(pJPEG, iLum0, &iDCPred0);
             if (pJPEG->ucMaxACCol == 0 || bThumbnail) // no AC components, save some time
@@ -3451,24 +3524,25 @@ static int DecodeJPEG(JPEGIMAGE *pJPEG)
                 } // switch on color option
             }
             xoff += mcuCX;
-            if (xoff == iPitch || x == cx-1) // time to draw
+            if (xoff == iPitch || x == iCropX1-1) // time to draw
             {
                 xoff = 0;
                 jd.iWidth = jd.iWidthUsed = iPitch; // width of each LCD block group
                 jd.pUser = pJPEG->pUser;
                 if (pJPEG->ucPixelType > EIGHT_BIT_GRAYSCALE) // dither to 4/2/1 bits
                     JPEGDither(pJPEG, cx * mcuCX, mcuCY);
-                if ((x+1)*mcuCX > pJPEG->iWidth) { // right edge has clipped pixels
-                   jd.iWidthUsed = iPitch - (cx*mcuCX - pJPEG->iWidth);
+                if ((x+1)*mcuCX > (pJPEG->iWidth>>iScaleShift)) { // right edge has clipped pixels
+                   jd.iWidthUsed = iPitch - (cx*mcuCX - (pJPEG->iWidth>>iScaleShift));
                 }
                 if ((jd.y - pJPEG->iYOffset + mcuCY) > (pJPEG->iHeight>>iScaleShift)) { // last row needs to be trimmed
                    jd.iHeight = (pJPEG->iHeight>>iScaleShift) - (jd.y - pJPEG->iYOffset);
                 }
                 bContinue = (*pJPEG->pfnDraw)(&jd);
                 jd.x += iPitch;
-                if ((cx - 1 - x) < iMCUCount) // change pitch for the last set of MCUs on this row
-                    iPitch = (cx - 1 - x) * mcuCX;
+                if ((iCropX1 - 1 - x) < iMCUCount) // change pitch for the last set of MCUs on this row
+                    iPitch = (iCropX1 - 1 - x) * mcuCX;
             }
+next_mcu:
             if (pJPEG->iResInterval)
             {
                 if (--pJPEG->iResCount == 0)
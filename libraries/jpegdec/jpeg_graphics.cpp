@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "jpeg_graphics.hpp"
+
+namespace pimoroni {
+
+  void JPEGGraphics::attach(JPEGDEC &jpeg) {
+    // 1-bit and 2-bit pens take 16 shades of grey, everything else takes
+    // RGB565 in the same byte order as our RGB565 framebuffers
+    switch(graphics->pen_type) {
+      case PicoGraphics::PEN_P2:
+      case PicoGraphics::PEN_1BIT:
+        jpeg.setPixelType(EIGHT_BIT_GRAYSCALE);
+        break;
+      default:
+        jpeg.setPixelType(RGB565_BIG_ENDIAN);
+        break;
+    }
+    jpeg.setUserPointer(this);
+  }
+
+  int JPEGGraphics::decode(JPEGDEC &jpeg, const Point &p, int options) {
+    attach(jpeg);
+    step = 0x10000;
+
+    int shift = options & JPEG_SCALE_HALF ? 1 : options & JPEG_SCALE_QUARTER ? 2 : options & JPEG_SCALE_EIGHTH ? 3 : 0;
+    bool thumbnail = options & JPEG_EXIF_THUMBNAIL;
+    area = Rect(p.x, p.y,
+                (thumbnail ? jpeg.getThumbWidth() : jpeg.getWidth()) >> shift,
+                (thumbnail ? jpeg.getThumbHeight() : jpeg.getHeight()) >> shift);
+
+    Rect visible = area.intersection(graphics->clip);
+    if(visible.empty()) return 1;
+    jpeg.setCropArea(visible.x - p.x, visible.y - p.y, visible.w, visible.h);
+
+    return jpeg.decode(p.x, p.y, options);
+  }
+
+  // the first output pixel sampling decoded pixel i or later
+  static inline int32_t first_sample(int32_t i, uint32_t step) {
+    return ((uint32_t)i * 0x10000 + step - 1) / step;
+  }
+
+  int JPEGGraphics::decode_fit(JPEGDEC &jpeg, const Rect &r) {
+    attach(jpeg);
+
+    int32_t w = jpeg.getWidth();
+    int32_t h = jpeg.getHeight();
+    if(r.empty() || w == 0 || h == 0) return 0;
+
+    // let the IDCT do as much of the scaling as it can
+    int shift = 0;
+    while(shift < 3 && ((w >> (shift + 1)) >= r.w || (h >> (shift + 1)) >= r.h)) shift++;
+    w >>= shift;
+    h >>= shift;
+
+    step = std::max((((uint32_t)w << 16) + r.w - 1) / r.w, (((uint32_t)h << 16) + r.h - 1) / r.h);
+    step = std::max(step, (uint32_t)0x10000);
+
+    int32_t fw = ((uint32_t)w << 16) / step;
+    int32_t fh = ((uint32_t)h << 16) / step;
+    area = Rect(r.x + (r.w - fw) / 2, r.y + (r.h - fh) / 2, fw, fh);
+
+    int options = shift == 1 ? JPEG_SCALE_HALF : shift == 2 ? JPEG_SCALE_QUARTER : shift == 3 ? JPEG_SCALE_EIGHTH : 0;
+    if(step == 0x10000) return decode(jpeg, {area.x, area.y}, options);
+
+    // only decode the part of the image that lands inside the clip rect
+    Rect visible = area.intersection(graphics->clip);
+    if(visible.empty()) return 1;
+    int32_t x0 = ((visible.x - area.x) * step) >> 16;
+    int32_t y0 = ((visible.y - area.y) * step) >> 16;
+    int32_t x1 = ((visible.x + visible.w - 1 - area.x) * step) >> 16;
+    int32_t y1 = ((visible.y + visible.h - 1 - area.y) * step) >> 16;
+    jpeg.setCropArea(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+
+    return jpeg.decode(0, 0, options);
+  }
+
+  int JPEGGraphics::draw_resampled(JPEGDRAW *draw) {
+    // the output pixels whose samples fall inside this block
+    int32_t x0 = first_sample(draw->x, step);
+    int32_t y0 = first_sample(draw->y, step);
+    int32_t x1 = first_sample(draw->x + draw->iWidthUsed, step);
+    int32_t y1 = first_sample(draw->y + draw->iHeight, step);
+    Rect r = Rect(area.x + x0, area.y + y0, x1 - x0, y1 - y0).intersection(area).intersection(graphics->clip);
+    if(r.empty()) return 1;
+
+    bool dither = !(flags & NO_DITHER);
+
+    for(auto y = r.y; y < r.y + r.h; y++) {
+      int32_t sy = (((y - area.y) * step) >> 16) - draw->y;
+
+      // gather the samples for this row into the start of its source row,
+      // as we only ever scale down none are overwritten before being read
+      if(draw->iBpp == 8) {
+        uint8_t *row = (uint8_t *)draw->pPixels + sy * draw->iWidth;
+        for(auto x = 0; x < r.w; x++) {
+          row[x] = row[(((r.x + x - area.x) * step) >> 16) - draw->x];
+        }
+        for(auto x = 0; x < r.w; x++) {
+          graphics->set_pen(row[x] >> 4);
+          graphics->set_pixel({r.x + x, y});
+        }
+      } else {
+        RGB565 *row = draw->pPixels + sy * draw->iWidth;
+        for(auto x = 0; x < r.w; x++) {
+          row[x] = row[(((r.x + x - area.x) * step) >> 16) - draw->x];
+        }
+        graphics->set_pixel_span_rgb565({r.x, y}, r.w, row, dither);
+      }
+    }
+
+    return 1;
+  }
+
+  int JPEGGraphics::draw(JPEGDRAW *draw) {
+    JPEGGraphics *target = (JPEGGraphics *)draw->pUser;
+    if(target->step != 0x10000) return target->draw_resampled(draw);
+
+    PicoGraphics *graphics = target->graphics;
+
+    // clip the block once rather than every pixel
+    Rect r = Rect(draw->x, draw->y, draw->iWidthUsed, draw->iHeight).intersection(graphics->clip);
+    if(r.empty()) return 1;
+
+    int32_t ox = r.x - draw->x;
+    int32_t oy = r.y - draw->y;
+
+    if(draw->iBpp == 8) {
+      const uint8_t *pixels = (const uint8_t *)draw->pPixels;
+      for(auto y = 0; y < r.h; y++) {
+        const uint8_t *src = pixels + (oy + y) * draw->iWidth + ox;
+        for(auto x = 0; x < r.w; x++) {
+          graphics->set_pen(*src++ >> 4);
+          graphics->set_pixel({r.x + x, r.y + y});
+        }
+      }
+    } else {
+      bool dither = !(target->flags & NO_DITHER);
+      for(auto y = 0; y < r.h; y++) {
+        const RGB565 *src = draw->pPixels + (oy + y) * draw->iWidth + ox;
+        graphics->set_pixel_span_rgb565({r.x, r.y + y}, r.w, src, dither);
+      }
+    }
+
+    return 1;
+  }
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "JPEGDEC.h"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+namespace pimoroni {
+
+  // Draws JPEGDEC output into a PicoGraphics surface. Each block of MCUs is
+  // clipped once and written a row at a time, straight into RGB565/RGB888
+  // buffers or through the pen's batched RGB565 converter otherwise.
+  //
+  //   JPEGDEC jpeg;
+  //   JPEGGraphics target(&graphics);
+  //   jpeg.openRAM(data, length, JPEGGraphics::draw);
+  //   target.decode(jpeg, {x, y});
+  //
+  // MCUs outside the clip rect are only entropy decoded, and decoding stops
+  // after the last row of MCUs inside it.
+  class JPEGGraphics {
+  public:
+    enum Flags : uint8_t {
+      // use the closest palette colour instead of dithering
+      NO_DITHER = 1,
+    };
+
+    PicoGraphics *graphics;
+    uint8_t flags;
+
+  private:
+    // when fitting to a rect the decoded image is resampled into area,
+    // stepping through it by step (16.16 fixed point) per output pixel
+    Rect area;
+    uint32_t step = 0x10000;
+
+    int draw_resampled(JPEGDRAW *draw);
+
+  public:
+    JPEGGraphics(PicoGraphics *graphics, uint8_t flags = 0) : graphics(graphics), flags(flags) {}
+
+    // select the JPEGDEC pixel type best suited to our pen and point the
+    // decoder at this target, call after opening the image
+    void attach(JPEGDEC &jpeg);
+
+    // decode the image with its top left corner at p, options are
+    // JPEGDEC's (eg. JPEG_SCALE_HALF)
+    int decode(JPEGDEC &jpeg, const Point &p, int options = 0);
+
+    // decode the image scaled down to fit inside r, centred and keeping its
+    // aspect ratio. The smallest DCT scale that doesn't leave the image
+    // smaller than r is used, and only the remainder is resampled. Images
+    // that already fit are drawn at full size
+    int decode_fit(JPEGDEC &jpeg, const Rect &r);
+
+    // JPEG_DRAW_CALLBACK to pass when opening the image
+    static int draw(JPEGDRAW *draw);
+  };
+
+}
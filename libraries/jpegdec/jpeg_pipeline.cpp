@@ -0,0 +1,111 @@
+#include <cstring>
+#include <new>
+
+#include "jpeg_pipeline.hpp"
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#else
+#include <thread>
+#endif
+
+namespace pimoroni {
+
+  static inline void wait() {
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+    tight_loop_contents();
+#else
+    std::this_thread::yield();
+#endif
+  }
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+  static JPEGPipeline *core1_pipeline = nullptr;
+
+  void JPEGPipeline::core1_entry() {
+    core1_pipeline->run();
+  }
+#endif
+
+  void JPEGPipeline::push(const JPEGDRAW *draw, bool last) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+
+    // wait for the drawing core to free up a slot
+    while(h - tail.load(std::memory_order_acquire) == SLOTS) wait();
+
+    slot_t &slot = slots[h % SLOTS];
+    slot.last = last;
+    if(!last) {
+      slot.draw = *draw;
+      memcpy(slot.pixels, draw->pPixels, draw->iWidth * draw->iHeight * draw->iBpp / 8);
+      slot.draw.pPixels = slot.pixels;
+      slot.draw.pUser = user;
+    }
+
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  void JPEGPipeline::run() {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+
+    while(true) {
+      while(head.load(std::memory_order_acquire) == t) wait();
+
+      slot_t &slot = slots[t % SLOTS];
+      if(slot.last) break;
+
+      // keep draining the ring after an abort so the decoder never stalls
+      if(!aborted.load(std::memory_order_relaxed) && !consumer(&slot.draw)) {
+        aborted.store(true, std::memory_order_release);
+      }
+
+      tail.store(++t, std::memory_order_release);
+    }
+
+    finished.store(true, std::memory_order_release);
+  }
+
+  int JPEGPipeline::draw(JPEGDRAW *draw) {
+    JPEGPipeline *pipeline = (JPEGPipeline *)draw->pUser;
+    if(pipeline->aborted.load(std::memory_order_acquire)) return 0;
+    pipeline->push(draw, false);
+    return 1;
+  }
+
+  int JPEGPipeline::decode(JPEGDEC &jpeg, int x, int y, int options) {
+    slots = new (std::nothrow) slot_t[SLOTS];
+    if(!slots) return 0;
+
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    aborted.store(false, std::memory_order_relaxed);
+    finished.store(false, std::memory_order_release);
+
+    jpeg.setUserPointer(this);
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+    core1_pipeline = this;
+    multicore_reset_core1();
+    multicore_launch_core1(core1_entry);
+#else
+    std::thread worker(&JPEGPipeline::run, this);
+#endif
+
+    int result = jpeg.decode(x, y, options);
+    push(nullptr, true);
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+    while(!finished.load(std::memory_order_acquire)) wait();
+    multicore_reset_core1();
+#else
+    worker.join();
+#endif
+
+    delete[] slots;
+    slots = nullptr;
+
+    return aborted.load(std::memory_order_acquire) ? 0 : result;
+  }
+
+}
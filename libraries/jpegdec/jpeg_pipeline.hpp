@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "JPEGDEC.h"
+
+namespace pimoroni {
+
+  // Splits JPEG decoding across both cores. The calling core runs JPEGDEC
+  // (entropy decoding, IDCT and colour conversion) and copies each finished
+  // block of MCUs into a ring of buffers, while the other core takes blocks
+  // off the ring and runs the draw callback on them. Pen conversion,
+  // dithering and display writes then overlap with decoding the next block.
+  //
+  //   JPEGGraphics target(&graphics);
+  //   JPEGPipeline pipeline(JPEGGraphics::draw, &target);
+  //   jpeg.openRAM(data, length, JPEGPipeline::draw);
+  //   target.attach(jpeg);
+  //   pipeline.decode(jpeg, x, y, 0);
+  //
+  // On RP2040 the draw callback runs on core1. decode() resets core1 before
+  // launching it and again once the image is drawn, stopping anything else
+  // running there. Elsewhere it runs on a thread.
+  class JPEGPipeline {
+  public:
+    // blocks of MCUs that can be decoded ahead of the draw callback
+    static const uint32_t SLOTS = 4;
+
+  private:
+    struct slot_t {
+      JPEGDRAW draw;
+      bool last;
+      uint16_t pixels[MAX_BUFFERED_PIXELS];
+    };
+
+    JPEG_DRAW_CALLBACK *consumer;
+    void *user;
+
+    // about 16KB, only allocated for the duration of decode()
+    slot_t *slots = nullptr;
+
+    // free-running counters, head is only written by the decoding core and
+    // tail by the drawing core
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<bool> aborted;
+    std::atomic<bool> finished;
+
+    void push(const JPEGDRAW *draw, bool last);
+    void run();
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+    static void core1_entry();
+#endif
+
+  public:
+    // draw is called on the other core with the user pointer set to user
+    JPEGPipeline(JPEG_DRAW_CALLBACK *draw, void *user) : consumer(draw), user(user) {}
+
+    // decode an image opened with JPEGPipeline::draw, returning once the
+    // last block has been drawn. Replaces the JPEGDEC user pointer, so
+    // set the pixel type (eg. with JPEGGraphics::attach) beforehand.
+    // Returns 0 if the slots can't be allocated
+    int decode(JPEGDEC &jpeg, int x, int y, int options);
+
+    // JPEG_DRAW_CALLBACK to pass when opening the image
+    static int draw(JPEGDRAW *draw);
+  };
+
+}
@@ -1,10 +1,16 @@
+if(NOT TARGET pico_graphics)
+    include(${CMAKE_CURRENT_LIST_DIR}/../pico_graphics/pico_graphics.cmake)
+endif()
+
 add_library(jpegdec
     ${CMAKE_CURRENT_LIST_DIR}/jpeg.cpp
     ${CMAKE_CURRENT_LIST_DIR}/JPEGDEC.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/jpeg_graphics.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/jpeg_pipeline.cpp
 )
 
 set_source_files_properties(${CMAKE_CURRENT_LIST_DIR}/JPEGDEC.cpp PROPERTIES COMPILE_FLAGS "-Wno-error=unused-function")
 
 target_include_directories(jpegdec INTERFACE ${CMAKE_CURRENT_LIST_DIR})
 
-target_link_libraries(jpegdec pico_stdlib)
\ No newline at end of file
+target_link_libraries(jpegdec pico_graphics pico_stdlib pico_multicore)
\ No newline at end of file
@@ -0,0 +1,7 @@
+add_library(lz_blocks
+    ${CMAKE_CURRENT_LIST_DIR}/lz_blocks.cpp
+)
+
+target_include_directories(lz_blocks INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+target_link_libraries(lz_blocks pico_stdlib)
@@ -0,0 +1,133 @@
+#include <string.h>
+#include <algorithm>
+
+#include "lz_blocks.hpp"
+
+namespace pimoroni {
+
+  static inline bool read_length(const uint8_t *&src, const uint8_t *end, uint32_t &length) {
+    uint8_t b;
+    do {
+      if(src == end) return false;
+      b = *src++;
+      length += b;
+    } while(b == 255);
+    return true;
+  }
+
+  uint32_t lz4_decompress(const uint8_t *src, uint32_t src_length, uint8_t *dest, uint32_t dest_length) {
+    const uint8_t *end = src + src_length;
+    uint8_t *out = dest;
+    uint8_t *out_end = dest + dest_length;
+
+    while(src < end) {
+      uint8_t token = *src++;
+
+      uint32_t literals = token >> 4;
+      if(literals == 15 && !read_length(src, end, literals)) return 0;
+      if(literals > uint32_t(end - src) || literals > uint32_t(out_end - out)) return 0;
+      memcpy(out, src, literals);
+      src += literals;
+      out += literals;
+
+      // the last sequence is only literals
+      if(src == end) break;
+
+      if(end - src < 2) return 0;
+      uint32_t offset = src[0] | (src[1] << 8);
+      src += 2;
+      if(offset == 0 || offset > uint32_t(out - dest)) return 0;
+
+      uint32_t length = token & 0xf;
+      if(length == 15 && !read_length(src, end, length)) return 0;
+      length += 4;
+      if(length > uint32_t(out_end - out)) return 0;
+
+      const uint8_t *match = out - offset;
+      if(offset >= length) {
+        memcpy(out, match, length);
+        out += length;
+      } else {
+        // overlapping copies repeat the last offset bytes
+        while(length--) *out++ = *match++;
+      }
+    }
+
+    return out - dest;
+  }
+
+  bool LZBlocks::open(const void *data, uint32_t length) {
+    this->data = (const uint8_t *)data;
+    header = nullptr;
+    offsets = nullptr;
+
+    const header_t *h = (const header_t *)data;
+    if(!data || length < sizeof(header_t) || h->magic != MAGIC || h->block_size == 0) return false;
+
+    // the blocks must cover the data exactly and the offsets stay in bounds
+    uint32_t count = h->block_count;
+    if(count != (h->size + h->block_size - 1) / h->block_size) return false;
+    if((length - sizeof(header_t)) / sizeof(uint32_t) < count + 1) return false;
+
+    const uint32_t *o = (const uint32_t *)(this->data + sizeof(header_t));
+    if(o[0] != sizeof(header_t) + (count + 1) * sizeof(uint32_t) || o[count] > length) return false;
+    for(auto i = 0u; i < count; i++) {
+      if(o[i + 1] < o[i]) return false;
+    }
+
+    header = h;
+    offsets = o;
+    return true;
+  }
+
+  uint32_t LZBlocks::block_length(uint32_t i) const {
+    if(!header || i >= header->block_count) return 0;
+    return std::min(header->block_size, header->size - i * header->block_size);
+  }
+
+  uint32_t LZBlocks::read_block(uint32_t i, void *dest) {
+    uint32_t length = block_length(i);
+    if(!length) return 0;
+
+    const uint8_t *src = data + offsets[i];
+    uint32_t src_length = offsets[i + 1] - offsets[i];
+
+    uint64_t t = time_us_64();
+    uint32_t n = length;
+    if(src_length == length) {
+      memcpy(dest, src, length);
+    } else {
+      n = lz4_decompress(src, src_length, (uint8_t *)dest, length);
+    }
+    stats.time_us += time_us_64() - t;
+
+    if(n != length) return 0;
+    stats.blocks++;
+    stats.bytes += n;
+    return n;
+  }
+
+  bool LZBlocks::read(uint32_t offset, void *dest, uint32_t length, uint8_t *scratch) {
+    if(!header || offset > header->size || length > header->size - offset) return false;
+
+    uint8_t *out = (uint8_t *)dest;
+    while(length) {
+      uint32_t block = offset / header->block_size;
+      uint32_t start = offset % header->block_size;
+      uint32_t n = std::min(length, block_length(block) - start);
+
+      if(start == 0 && n == block_length(block)) {
+        if(!read_block(block, out)) return false;
+      } else {
+        if(!read_block(block, scratch)) return false;
+        memcpy(out, scratch + start, n);
+      }
+
+      out += n;
+      offset += n;
+      length -= n;
+    }
+    return true;
+  }
+
+}
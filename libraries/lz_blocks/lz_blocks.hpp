@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#include "pico/stdlib.h"
+
+// Block compressed data
+//
+// Data is split into fixed size blocks which are LZ4 compressed on their own
+// by lz_pack.py, so any block can be decoded straight into a row, span or
+// audio buffer without decompressing the whole thing or keeping a window of
+// history around. The compressed data is read in place, from flash or
+// anywhere else.
+//
+// The stream starts with a header and a table of block offsets:
+//
+//   uint32_t magic;          // "LZBK"
+//   uint32_t size;           // uncompressed size of the data
+//   uint32_t block_size;     // uncompressed size of every block but the last
+//   uint32_t block_count;
+//   uint32_t offsets[block_count + 1];  // from the start of the stream
+//
+// A block whose compressed size is the same as its uncompressed size is
+// stored as it is.
+namespace pimoroni {
+
+  // decode one LZ4 block into dest, returning the number of bytes written or
+  // 0 if src is corrupt or wouldn't fit
+  uint32_t lz4_decompress(const uint8_t *src, uint32_t src_length, uint8_t *dest, uint32_t dest_length);
+
+  class LZBlocks {
+  public:
+    static const uint32_t MAGIC = 0x4b425a4c; // "LZBK"
+
+    struct header_t {
+      uint32_t magic;
+      uint32_t size;
+      uint32_t block_size;
+      uint32_t block_count;
+    };
+
+    // time spent decoding, for working out throughput
+    struct stats_t {
+      uint32_t blocks;
+      uint32_t bytes;       // decompressed
+      uint64_t time_us;
+
+      float mb_per_second() const {
+        return time_us ? float(bytes) / time_us : 0.0f;
+      }
+    };
+
+  private:
+    const uint8_t *data = nullptr;
+    const header_t *header = nullptr;
+    const uint32_t *offsets = nullptr;
+    stats_t stats = {};
+
+  public:
+    LZBlocks() {}
+    LZBlocks(const void *data, uint32_t length) {open(data, length);}
+
+    // false if this isn't valid block compressed data
+    bool open(const void *data, uint32_t length);
+    bool valid() const {return header != nullptr;}
+
+    uint32_t size() const {return header ? header->size : 0;}
+    uint32_t block_size() const {return header ? header->block_size : 0;}
+    uint32_t block_count() const {return header ? header->block_count : 0;}
+
+    // uncompressed size of block i
+    uint32_t block_length(uint32_t i) const;
+
+    // decompress block i into dest, which must have room for block_size()
+    // bytes. Returns the number of bytes written, 0 on error
+    uint32_t read_block(uint32_t i, void *dest);
+
+    // decompress length bytes starting at offset into dest, decoding each
+    // block touched through scratch (block_size() bytes) unless it can go
+    // straight into dest
+    bool read(uint32_t offset, void *dest, uint32_t length, uint8_t *scratch);
+
+    const stats_t &get_stats() const {return stats;}
+    void reset_stats() {stats = {};}
+  };
+
+}
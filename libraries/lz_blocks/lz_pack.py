@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+
+# compresses a file into independently decodable LZ4 blocks for
+# pimoroni::LZBlocks, either as a binary or as a C array to build in
+#
+#   ./lz_pack.py sample.raw -o sample.lz --block-size 1024
+#   ./lz_pack.py image.rgb565 -o image_lz.cpp --c-array image_lz --block-size 640
+#
+# each block is compressed on its own, so any block can be decoded straight
+# into a caller's buffer without the ones before it. For images make the
+# block size a whole number of rows, for audio the size of the playback
+# buffer. Blocks that don't shrink are stored as they are
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x4b425a4c  # "LZBK"
+
+MIN_MATCH = 4
+LAST_LITERALS = 5   # the LZ4 block format ends with at least 5 literals
+MF_LIMIT = 12       # and no match may start within 12 bytes of the end
+MAX_OFFSET = 65535
+HASH_BITS = 14
+
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def write_sequence(out, literals, match_length, offset):
+    lit = len(literals)
+    token = min(lit, 15) << 4
+    if match_length:
+        token |= min(match_length - MIN_MATCH, 15)
+    out.append(token)
+    if lit >= 15:
+        write_length(out, lit - 15)
+    out += literals
+    if match_length:
+        out += struct.pack("<H", offset)
+        if match_length - MIN_MATCH >= 15:
+            write_length(out, match_length - MIN_MATCH - 15)
+
+
+def compress(data):
+    # greedy LZ4 with a single-entry hash table, plenty for assets built once
+    out = bytearray()
+    table = {}
+    n = len(data)
+    anchor = 0
+    i = 0
+    limit = n - MF_LIMIT
+
+    while i < limit:
+        key = data[i:i + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > MAX_OFFSET:
+            i += 1
+            continue
+
+        # extend the match, stopping short of the trailing literals
+        length = MIN_MATCH
+        end = n - LAST_LITERALS
+        while i + length < end and data[candidate + length] == data[i + length]:
+            length += 1
+
+        write_sequence(out, data[anchor:i], length, i - candidate)
+        for j in range(i + 1, min(i + length, limit)):
+            table[data[j:j + MIN_MATCH]] = j
+        i += length
+        anchor = i
+
+    write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def pack(data, block_size):
+    blocks = []
+    for start in range(0, len(data), block_size):
+        raw = data[start:start + block_size]
+        packed = compress(raw)
+        blocks.append(packed if len(packed) < len(raw) else raw)
+
+    index_size = 16 + 4 * (len(blocks) + 1)
+    offsets = [index_size]
+    for block in blocks:
+        offsets.append(offsets[-1] + len(block))
+
+    header = struct.pack("<IIII", MAGIC, len(data), block_size, len(blocks))
+    return header + struct.pack(f"<{len(offsets)}I", *offsets) + b"".join(blocks)
+
+
+def c_array(name, data):
+    lines = [f"// {len(data)} bytes of LZ4 blocks, see libraries/lz_blocks", "#include <stdint.h>", ""]
+    lines.append(f"alignas(4) const uint8_t {name}[] = {{")
+    for i in range(0, len(data), 12):
+        lines.append("  " + ", ".join(f"0x{b:02x}" for b in data[i:i + 12]) + ",")
+    lines.append("};")
+    lines.append(f"const uint32_t {name}_len = {len(data)};")
+    return "\n".join(lines) + "\n"
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Compresses a file into LZ4 blocks for LZBlocks.")
+    parser.add_argument("input", help="file to compress")
+    parser.add_argument("-o", "--output", required=True, help="output file")
+    parser.add_argument("--block-size", type=int, default=1024, help="uncompressed size of each block in bytes")
+    parser.add_argument("--c-array", metavar="NAME", help="write a C array called NAME instead of a binary")
+    parser.add_argument("--skip", type=int, default=0, help="bytes to drop from the start, eg: 44 for a WAV header")
+
+    options = parser.parse_args()
+
+    if options.block_size < 1 or options.block_size > 65536:
+        sys.exit("block size must be between 1 and 65536 bytes")
+
+    with open(options.input, "rb") as f:
+        data = f.read()[options.skip:]
+
+    packed = pack(data, options.block_size)
+
+    if options.c_array:
+        with open(options.output, "w") as f:
+            f.write(c_array(options.c_array, packed))
+    else:
+        with open(options.output, "wb") as f:
+            f.write(packed)
+
+    print(f"{len(data)} -> {len(packed)} bytes ({100 * len(packed) / max(len(data), 1):.1f}%)")
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+
+# builds an asset pack which can be written to flash separately from the
+# firmware and read in place by pimoroni::AssetPack
+#
+#   ./pack.py -o assets.bin logo=logo.png:rgb565 roboto24=roboto24.aaf tune=tune.raw
+#   picotool load -o 0x10100000 assets.bin
+#
+# assets are given as name=path, with an optional :format for images.
+# images (.png, .bmp, .gif, .jpg) are converted with Pillow (pip install pillow)
+# into rgb332, rgb565 (the default) or rgb888, .aaf files are anti-aliased
+# fonts written by `aa_fonts/convert.py --binary` and anything else is
+# stored as-is
+#
+# add :lz to compress an image or raw asset into LZ4 blocks (see
+# libraries/lz_blocks), eg: logo=logo.png:rgb565:lz or tune=tune.raw:lz.
+# images are compressed a few rows per block so they can be drawn a row at
+# a time, raw assets in blocks of --block-size bytes
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "lz_blocks"))
+import lz_pack  # noqa: E402
+
+MAGIC = 0x4b415041  # "APAK"
+VERSION = 1
+NAME_LENGTH = 24
+HEADER_SIZE = 12
+ENTRY_SIZE = 40
+
+ASSET_RAW = 0
+ASSET_IMAGE = 1
+ASSET_AA_FONT = 2
+
+FORMATS = {"rgb332": 1, "rgb565": 2, "rgb888": 3}
+BYTES_PER_PIXEL = {"rgb332": 1, "rgb565": 2, "rgb888": 4}
+
+COMPRESSION_NONE = 0
+COMPRESSION_LZ_BLOCKS = 1
+
+# images are compressed in blocks of whole rows, about this big
+IMAGE_BLOCK_SIZE = 2048
+IMAGE_EXTENSIONS = (".png", ".bmp", ".gif", ".jpg", ".jpeg")
+
+parser = argparse.ArgumentParser(description="Builds an asset pack for reading in place from flash.")
+parser.add_argument("assets", nargs="+", help="assets to pack as name=path[:format][:lz]")
+parser.add_argument("-o", "--output", required=True, help="output file")
+parser.add_argument("--align", type=int, default=4, help="alignment of each asset in bytes, at least 4 for DMA")
+parser.add_argument("--block-size", type=int, default=1024, help="uncompressed block size for compressed raw assets")
+
+options = parser.parse_args()
+
+
+def convert_image(path, fmt):
+    from PIL import Image
+
+    image = Image.open(path).convert("RGB")
+    data = bytearray()
+    for r, g, b in image.getdata():
+        if fmt == "rgb332":
+            data.append((r & 0b11100000) | ((g >> 3) & 0b00011100) | (b >> 6))
+        elif fmt == "rgb565":
+            # PicoGraphics stores RGB565 byte-swapped, ready to send to a display
+            data += struct.pack(">H", ((r & 0b11111000) << 8) | ((g & 0b11111100) << 3) | (b >> 3))
+        else:
+            # RGB888 pixels are stored as 32-bit words
+            data += struct.pack("<I", (r << 16) | (g << 8) | b)
+    return image.width, image.height, bytes(data)
+
+
+def try_compress(data, block_size):
+    # anything that doesn't shrink is stored as it is
+    packed = lz_pack.pack(data, block_size)
+    if len(packed) < len(data):
+        return True, packed
+    return False, data
+
+
+def load_asset(spec):
+    if "=" not in spec:
+        raise ValueError(f"{spec}: expected name=path")
+
+    name, path = spec.split("=", 1)
+    fmt = None
+    compress = False
+    while ":" in path and path.rsplit(":", 1)[1] in (*FORMATS, "lz"):
+        path, option = path.rsplit(":", 1)
+        if option == "lz":
+            compress = True
+        else:
+            fmt = option
+
+    if len(name.encode()) > NAME_LENGTH:
+        raise ValueError(f"{name}: names must be at most {NAME_LENGTH} bytes")
+
+    path = Path(path)
+    suffix = path.suffix.lower()
+
+    if suffix in IMAGE_EXTENSIONS:
+        fmt = fmt or "rgb565"
+        if fmt not in FORMATS:
+            raise ValueError(f"{name}: unknown image format {fmt}, expected one of {', '.join(FORMATS)}")
+        width, height, data = convert_image(path, fmt)
+        if compress:
+            row_bytes = width * BYTES_PER_PIXEL[fmt]
+            compress, data = try_compress(data, row_bytes * max(1, IMAGE_BLOCK_SIZE // row_bytes))
+        return name, ASSET_IMAGE, FORMATS[fmt], width, height, compress, data
+
+    if fmt:
+        raise ValueError(f"{name}: :{fmt} only applies to images")
+
+    data = path.read_bytes()
+    if suffix == ".aaf":
+        # fonts are read in place, so can't be compressed
+        if compress:
+            raise ValueError(f"{name}: fonts can't be compressed")
+        return name, ASSET_AA_FONT, 0, 0, 0, False, data
+
+    if compress:
+        compress, data = try_compress(data, options.block_size)
+    return name, ASSET_RAW, 0, 0, 0, compress, data
+
+
+def build_pack(assets, align):
+    offset = HEADER_SIZE + ENTRY_SIZE * len(assets)
+    index = b""
+    body = b""
+
+    for name, asset_type, fmt, width, height, compress, data in assets:
+        padding = -offset % align
+        body += bytes(padding)
+        offset += padding
+
+        compression = COMPRESSION_LZ_BLOCKS if compress else COMPRESSION_NONE
+        index += struct.pack(f"<{NAME_LENGTH}sBBHHBBII", name.encode(), asset_type, fmt, width, height, compression, 0, offset, len(data))
+        body += data
+        offset += len(data)
+
+    # round the whole pack up to a word so the last asset can be streamed in full
+    body += bytes(-offset % 4)
+    offset += -offset % 4
+
+    header = struct.pack("<IHHI", MAGIC, VERSION, len(assets), offset)
+    return header + index + body
+
+
+try:
+    if options.align < 4 or options.align & (options.align - 1):
+        raise ValueError("--align must be a power of two, at least 4")
+
+    assets = [load_asset(spec) for spec in options.assets]
+
+    names = [a[0] for a in assets]
+    if len(set(names)) != len(names):
+        raise ValueError("asset names must be unique")
+
+    pack = build_pack(assets, options.align)
+    Path(options.output).write_bytes(pack)
+
+    print(f"{options.output}: {len(assets)} assets, {len(pack)} bytes")
+    for name, asset_type, fmt, width, height, compress, data in assets:
+        print(f"  {name}: {len(data)} bytes{' compressed' if compress else ''}")
+except (ValueError, OSError) as e:
+    print(f"error: {e}", file=sys.stderr)
+    sys.exit(1)
@@ -0,0 +1,7 @@
+add_library(pico_assets
+    ${CMAKE_CURRENT_LIST_DIR}/pico_assets.cpp
+)
+
+target_include_directories(pico_assets INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+target_link_libraries(pico_assets aa_fonts lz_blocks pico_graphics pico_stdlib hardware_dma)
@@ -0,0 +1,215 @@
+#include <string.h>
+#include <memory>
+#include <new>
+
+#include "hardware/address_mapped.h"
+#include "hardware/dma.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/structs/xip_ctrl.h"
+
+#include "pico_assets.hpp"
+
+namespace pimoroni {
+
+  // The index and font tables are read straight out of the pack, so their
+  // layouts must match what pack.py writes
+  static_assert(sizeof(AssetPack::header_t) == 12, "unexpected asset pack header size");
+  static_assert(sizeof(AssetPack::asset_t) == 40, "unexpected asset index entry size");
+  static_assert(sizeof(AssetPack::aa_font_header_t) == 20, "unexpected font header size");
+  static_assert(sizeof(aa::glyph_t) == 12, "unexpected glyph size");
+  static_assert(sizeof(aa::kerning_t) == 6, "unexpected kerning size");
+
+  AssetPack::AssetPack(uint32_t flash_offset) : AssetPack((const void *)(uintptr_t)(XIP_BASE + flash_offset)) {}
+
+  AssetPack::AssetPack(const void *data) : base((const uint8_t *)data) {
+    if(!valid()) base = nullptr;
+  }
+
+  bool AssetPack::valid() const {
+    if(!base) return false;
+
+    const header_t *header = (const header_t *)base;
+    if(header->magic != MAGIC || header->version != VERSION) return false;
+
+    // an erased flash or partly written pack shouldn't send us reading off into the weeds
+    uint32_t index_end = sizeof(header_t) + header->count * sizeof(asset_t);
+    if(index_end > header->size) return false;
+
+    for(auto i = 0u; i < header->count; i++) {
+      const asset_t *asset = get(i);
+      // offset is checked first so the subtraction can't wrap
+      if(asset->offset < index_end || asset->offset > header->size || asset->length > header->size - asset->offset) return false;
+    }
+
+    return true;
+  }
+
+  uint AssetPack::count() const {
+    return base ? ((const header_t *)base)->count : 0;
+  }
+
+  const AssetPack::asset_t *AssetPack::get(uint i) const {
+    if(i >= count()) return nullptr;
+    return (const asset_t *)(base + sizeof(header_t)) + i;
+  }
+
+  const AssetPack::asset_t *AssetPack::find(const char *name) const {
+    for(auto i = 0u; i < count(); i++) {
+      const asset_t *asset = get(i);
+      if(strncmp(asset->name, name, NAME_LENGTH) == 0) return asset;
+    }
+    return nullptr;
+  }
+
+  const uint8_t *AssetPack::data(const asset_t *asset) const {
+    return asset ? base + asset->offset : nullptr;
+  }
+
+  aa::font_t AssetPack::aa_font(const asset_t *asset) const {
+    if(!asset || asset->type != ASSET_AA_FONT || asset->length < sizeof(aa_font_header_t)) {
+      return {1, 0, 0, 0, nullptr, nullptr, nullptr};
+    }
+
+    const uint8_t *d = data(asset);
+    const aa_font_header_t *header = (const aa_font_header_t *)d;
+
+    // the tables are read in place, so they have to lie within the asset
+    uint32_t length = asset->length;
+    uint32_t glyphs_size = header->glyph_count * sizeof(aa::glyph_t);
+    uint32_t kerning_size = header->kerning_count * sizeof(aa::kerning_t);
+    if(header->glyphs > length || glyphs_size > length - header->glyphs ||
+       header->kerning > length || kerning_size > length - header->kerning ||
+       header->data > length) {
+      return {1, 0, 0, 0, nullptr, nullptr, nullptr};
+    }
+
+    return {
+      header->bpp,
+      header->line_height,
+      header->glyph_count,
+      header->kerning_count,
+      (const aa::glyph_t *)(d + header->glyphs),
+      header->kerning_count ? (const aa::kerning_t *)(d + header->kerning) : nullptr,
+      d + header->data
+    };
+  }
+
+  bool AssetPack::stream(const asset_t *asset, uint32_t offset, void *dest, uint32_t len, uint dma_channel) const {
+    if(!asset || offset > asset->length || len > asset->length - offset || (offset | len) & 0b11) return false;
+
+    const uint8_t *src = data(asset) + offset;
+    uint32_t words = len >> 2;
+
+    dma_channel_config config = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_write_increment(&config, true);
+
+    if((uintptr_t)src >= XIP_BASE && (uintptr_t)src < XIP_NOALLOC_BASE) {
+      // stop a stream that's still running, then drain what it left in the
+      // FIFO, before starting a new one
+      xip_ctrl_hw->stream_ctr = 0;
+      while(!(xip_ctrl_hw->stat & XIP_STAT_FIFO_EMPTY)) {
+        (void)xip_ctrl_hw->stream_fifo;
+      }
+      xip_ctrl_hw->stream_addr = (uintptr_t)src;
+      xip_ctrl_hw->stream_ctr = words;
+
+      channel_config_set_read_increment(&config, false);
+      channel_config_set_dreq(&config, DREQ_XIP_STREAM);
+      dma_channel_configure(dma_channel, &config, dest, (const void *)XIP_AUX_BASE, words, true);
+    } else {
+      // packs that aren't in flash are just copied
+      channel_config_set_read_increment(&config, true);
+      dma_channel_configure(dma_channel, &config, dest, src, words, true);
+    }
+
+    return true;
+  }
+
+  LZBlocks AssetPack::blocks(const asset_t *asset) const {
+    if(!asset || asset->compression != COMPRESSION_LZ_BLOCKS) return LZBlocks();
+    return LZBlocks(data(asset), asset->length);
+  }
+
+  bool AssetPack::draw_image(PicoGraphics *graphics, const asset_t *asset, const Point &p, bool dither) const {
+    if(!graphics || !asset || asset->type != ASSET_IMAGE) return false;
+
+    uint32_t bpp;
+    switch(asset->format) {
+      case FORMAT_RGB332: bpp = 1; break;
+      case FORMAT_RGB565: bpp = 2; break;
+      case FORMAT_RGB888: bpp = 4; break;
+      default: return false;
+    }
+    uint32_t row_bytes = asset->width * bpp;
+    uint32_t image_bytes = row_bytes * asset->height;
+
+    // compressed images must hold whole rows in every block so a row never
+    // spans two of them
+    LZBlocks lz;
+    if(asset->compression == COMPRESSION_LZ_BLOCKS) {
+      lz = blocks(asset);
+      if(!lz.valid() || lz.size() != image_bytes || lz.block_size() % row_bytes) return false;
+    } else if(asset->compression != COMPRESSION_NONE || asset->length < image_bytes) {
+      return false;
+    }
+
+    Rect area = Rect(p.x, p.y, asset->width, asset->height).intersection(graphics->clip);
+    if(area.empty()) return true;
+
+    std::unique_ptr<uint8_t[]> block;
+    if(lz.valid()) {
+      block.reset(new (std::nothrow) uint8_t[lz.block_size()]);
+      if(!block) return false;
+    }
+
+    // RGB565 rows are stored ready to draw, anything else is converted
+    std::unique_ptr<RGB565[]> span;
+    if(asset->format != FORMAT_RGB565) {
+      span.reset(new (std::nothrow) RGB565[area.w]);
+      if(!span) return false;
+    }
+
+    const uint8_t *pixels = data(asset);
+    uint32_t skip = (area.x - p.x) * bpp;
+    uint32_t current = UINT32_MAX;
+    bool ok = true;
+
+    for(int32_t y = area.y; y < area.y + area.h; y++) {
+      uint32_t offset = (y - p.y) * row_bytes;
+      const uint8_t *row;
+      if(lz.valid()) {
+        // only the blocks covering visible rows are decoded
+        uint32_t i = offset / lz.block_size();
+        if(i != current) {
+          if(!lz.read_block(i, block.get())) {ok = false; break;}
+          current = i;
+        }
+        row = block.get() + offset % lz.block_size() + skip;
+      } else {
+        row = pixels + offset + skip;
+      }
+
+      const RGB565 *src = span.get();
+      switch(asset->format) {
+        case FORMAT_RGB332:
+          for(auto x = 0; x < area.w; x++) span[x] = RGB((RGB332)row[x]).to_rgb565();
+          break;
+        case FORMAT_RGB888:
+          for(auto x = 0; x < area.w; x++) span[x] = RGB((uint)((const uint32_t *)row)[x]).to_rgb565();
+          break;
+        default:
+          src = (const RGB565 *)row;
+          break;
+      }
+      graphics->set_pixel_span_rgb565(Point(area.x, y), area.w, src, dither);
+    }
+
+    const LZBlocks::stats_t &stats = lz.get_stats();
+    decode_stats.blocks += stats.blocks;
+    decode_stats.bytes += stats.bytes;
+    decode_stats.time_us += stats.time_us;
+    return ok;
+  }
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+
+#include "pico/stdlib.h"
+#include "libraries/aa_fonts/aa_fonts.hpp"
+#include "libraries/lz_blocks/lz_blocks.hpp"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+// Asset packs
+//
+// A pack is a single binary image, built with pack.py, which is written to a
+// spare region of flash (eg: with `picotool load -o`) separately from the
+// firmware. Assets are read in place through XIP so they take no SRAM and can
+// be updated without rebuilding the firmware.
+//
+// The pack starts with a header and an index of fixed size entries, followed
+// by the asset data. Every asset starts on a word boundary so it can be
+// streamed out of flash by DMA.
+//
+// Image and raw assets can be stored as LZ4 blocks (see lz_blocks.hpp) to
+// save flash. Compressed images hold a few whole rows per block and are
+// decoded a block at a time by draw_image(), other compressed assets are
+// read through blocks().
+namespace pimoroni {
+
+  class AssetPack {
+  public:
+    static const uint32_t MAGIC = 0x4b415041; // "APAK"
+    static const uint16_t VERSION = 1;
+    static const uint NAME_LENGTH = 24;
+
+    enum AssetType : uint8_t {
+      ASSET_RAW = 0,      // arbitrary data
+      ASSET_IMAGE = 1,    // uncompressed image in a PicoGraphics framebuffer format
+      ASSET_AA_FONT = 2,  // anti-aliased font, see aa_font()
+    };
+
+    enum ImageFormat : uint8_t {
+      FORMAT_NONE = 0,
+      FORMAT_RGB332 = 1,
+      FORMAT_RGB565 = 2,  // byte-swapped, as stored by PicoGraphics_PenRGB565
+      FORMAT_RGB888 = 3,
+    };
+
+    enum Compression : uint8_t {
+      COMPRESSION_NONE = 0,
+      COMPRESSION_LZ_BLOCKS = 1,  // LZBlocks stream, length is the compressed size
+    };
+
+    struct header_t {
+      uint32_t magic;
+      uint16_t version;
+      uint16_t count;     // number of index entries
+      uint32_t size;      // total size of the pack in bytes, including this header
+    };
+
+    struct asset_t {
+      char name[NAME_LENGTH]; // nul padded, not necessarily nul terminated
+      uint8_t type;
+      uint8_t format;
+      uint16_t width;
+      uint16_t height;
+      uint8_t compression;
+      uint8_t reserved;
+      uint32_t offset;    // from the start of the pack
+      uint32_t length;
+    };
+
+    // anti-aliased font assets start with this header, the offsets are
+    // from the start of the asset
+    struct aa_font_header_t {
+      uint8_t bpp;
+      uint8_t line_height;
+      uint16_t glyph_count;
+      uint16_t kerning_count;
+      uint16_t reserved;
+      uint32_t glyphs;
+      uint32_t kerning;
+      uint32_t data;
+    };
+
+  private:
+    const uint8_t *base = nullptr;
+    mutable LZBlocks::stats_t decode_stats = {};
+
+  public:
+    // map a pack written at the given offset into flash
+    AssetPack(uint32_t flash_offset);
+    // use a pack that's already somewhere in the address space
+    AssetPack(const void *data);
+
+    // false if there is no valid pack at the given location
+    bool valid() const;
+
+    uint count() const;
+    const asset_t *get(uint i) const;
+    const asset_t *find(const char *name) const;
+
+    // pointer to the asset data, readable in place
+    const uint8_t *data(const asset_t *asset) const;
+
+    // build a font whose glyphs and data are read in place from flash,
+    // an invalid asset returns a font with no glyphs
+    aa::font_t aa_font(const asset_t *asset) const;
+
+    // start streaming len bytes from offset within the asset into dest with
+    // DMA, through the XIP streaming FIFO so the XIP cache is not disturbed.
+    // offset and len must be multiples of four. Use
+    // dma_channel_wait_for_finish_blocking() to wait for the transfer
+    bool stream(const asset_t *asset, uint32_t offset, void *dest, uint32_t len, uint dma_channel) const;
+
+    // the blocks of a compressed asset, invalid if it isn't compressed
+    LZBlocks blocks(const asset_t *asset) const;
+
+    // draw an image asset with its top left corner at p, clipped to the
+    // graphics clip rect. Compressed images are decoded a block at a time
+    // into a buffer allocated for the call. False if the asset isn't an
+    // image, is corrupt or there's no memory
+    bool draw_image(PicoGraphics *graphics, const asset_t *asset, const Point &p, bool dither = true) const;
+
+    // decompression totals across draw_image() calls
+    const LZBlocks::stats_t &get_decode_stats() const {return decode_stats;}
+    void reset_decode_stats() const {decode_stats = {};}
+  };
+
+}
@@ -0,0 +1,172 @@
+// Compares drawing text with a scaled up 1-bit bitmap font against an
+// anti-aliased font of the same size, into a 320x240 RGB565 buffer.
+//
+// By default the anti-aliased font is made from font8 at startup, smoothing
+// each glyph up to the same scale at 4bpp, so both draw the same shapes.
+// Smoothing a 1-bit font blurs every edge, so for a realistic comparison pass
+// a font made by `convert.py --binary` instead:
+//
+//   aa_text_benchmark font.bin
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+using namespace pimoroni;
+
+static const char *TEXT = "The quick brown fox jumps over the lazy dog. "
+                          "Pack my box with five dozen liquor jugs! 0123456789";
+
+// matches rle_encode() in libraries/aa_fonts/convert.py
+static void rle_encode(const std::vector<uint8_t> &pixels, uint8_t bpp, std::vector<uint8_t> &data) {
+  const size_t max_run = 256 >> bpp;
+  size_t i = 0;
+  while(i < pixels.size()) {
+    uint8_t value = pixels[i];
+    size_t run = 1;
+    while(i + run < pixels.size() && pixels[i + run] == value && run < max_run) run++;
+    data.push_back(((run - 1) << bpp) | value);
+    i += run;
+  }
+}
+
+struct smoothed_font_t {
+  std::vector<aa::glyph_t> glyphs;
+  std::vector<uint8_t> data;
+  aa::font_t *font;
+};
+
+// font8 scaled by scale, with coverage bilinearly interpolated from the 1-bit glyphs
+static void make_font(smoothed_font_t &f, int scale) {
+  const bitmap::font_t *src = &font8;
+  for(int c = 32; c < 127; c++) {
+    int w = bitmap::measure_character(src, c, 1);
+    int h = src->height;
+
+    std::vector<uint8_t> bits(w * h, 0);
+    bitmap::character(src, [&](int32_t x, int32_t y, int32_t rw, int32_t rh) {
+      for(int j = y; j < y + rh; j++)
+        for(int i = x; i < x + rw; i++)
+          if(i >= 0 && i < w && j >= 0 && j < h) bits[i + j * w] = 1;
+    }, c, 0, 0, 1);
+
+    auto bit = [&](int x, int y) -> float {
+      return (x < 0 || y < 0 || x >= w || y >= h) ? 0.0f : bits[x + y * w];
+    };
+
+    // one pixel of margin for the smoothed edges
+    int gw = (w + 1) * scale, gh = (h + 1) * scale;
+    std::vector<uint8_t> pixels(gw * gh);
+    for(int y = 0; y < gh; y++) {
+      for(int x = 0; x < gw; x++) {
+        float sx = (x + 0.5f) / scale - 1.0f, sy = (y + 0.5f) / scale - 1.0f;
+        int ix = floorf(sx), iy = floorf(sy);
+        float fx = sx - ix, fy = sy - iy;
+        float v = bit(ix, iy) * (1 - fx) * (1 - fy) + bit(ix + 1, iy) * fx * (1 - fy)
+                + bit(ix, iy + 1) * (1 - fx) * fy + bit(ix + 1, iy + 1) * fx * fy;
+        pixels[x + y * gw] = uint8_t(v * 15.0f + 0.5f);
+      }
+    }
+
+    f.glyphs.push_back({uint16_t(c), uint8_t(gw), uint8_t(gh), int8_t(-scale / 2), int8_t(-scale / 2),
+                        uint8_t((w + 1) * scale), uint32_t(f.data.size())});
+    rle_encode(pixels, 4, f.data);
+  }
+
+  f.font = new aa::font_t{4, uint8_t((src->height + 2) * scale), uint16_t(f.glyphs.size()), 0, f.glyphs.data(), nullptr, f.data.data()};
+}
+
+// header written by convert.py --binary, followed by the glyph and kerning
+// tables laid out as in memory
+struct font_file_header_t {
+  uint8_t bpp;
+  uint8_t line_height;
+  uint16_t glyph_count;
+  uint16_t kerning_count;
+  uint16_t reserved;
+  uint32_t glyphs_offset;
+  uint32_t kerning_offset;
+  uint32_t data_offset;
+};
+
+static bool load_font(const char *filename, std::vector<uint8_t> &file, aa::font_t *&font) {
+  std::ifstream f(filename, std::ios::binary);
+  file.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  if(file.size() < sizeof(font_file_header_t)) return false;
+
+  font_file_header_t h;
+  memcpy(&h, file.data(), sizeof(h));
+  if(h.data_offset > file.size() || h.glyphs_offset + h.glyph_count * sizeof(aa::glyph_t) > h.kerning_offset) return false;
+
+  font = new aa::font_t{h.bpp, h.line_height, h.glyph_count, h.kerning_count,
+                        (const aa::glyph_t *)&file[h.glyphs_offset],
+                        (const aa::kerning_t *)&file[h.kerning_offset],
+                        &file[h.data_offset]};
+  return true;
+}
+
+template<typename F>
+static double time_us(F draw) {
+  const int runs = 200;
+  double best = 1e9;
+  for(int i = 0; i < 5; i++) {
+    auto start = std::chrono::steady_clock::now();
+    for(int j = 0; j < runs; j++) draw();
+    std::chrono::duration<double, std::micro> t = std::chrono::steady_clock::now() - start;
+    best = std::min(best, t.count() / runs);
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  static uint16_t buffer[320 * 240];
+  PicoGraphics_PenRGB565 graphics(320, 240, buffer);
+  graphics.set_pen(255, 255, 255);
+
+  aa::font_t *loaded = nullptr;
+  std::vector<uint8_t> file;
+  if(argc > 1 && !load_font(argv[1], file, loaded)) {
+    fprintf(stderr, "couldn't load %s\n", argv[1]);
+    return 1;
+  }
+
+  printf("%zu characters wrapped to 320 pixels, microseconds per draw\n\n", strlen(TEXT));
+  printf("scale  bitmap  anti-aliased\n");
+
+  for(int scale = 2; scale <= 4; scale++) {
+    graphics.set_font(&font8);
+    double bitmap_us = time_us([&]() {
+      graphics.text(TEXT, Point(0, 0), 320, scale);
+    });
+
+    if(loaded) {
+      printf("%5d  %6.1f\n", scale, bitmap_us);
+      continue;
+    }
+
+    smoothed_font_t smoothed;
+    make_font(smoothed, scale);
+    graphics.set_font(smoothed.font);
+    double aa_us = time_us([&]() {
+      graphics.text(TEXT, Point(0, 0), 320);
+    });
+    printf("%5d  %6.1f  %12.1f\n", scale, bitmap_us, aa_us);
+    delete smoothed.font;
+  }
+
+  if(loaded) {
+    graphics.set_font(loaded);
+    double aa_us = time_us([&]() {
+      graphics.text(TEXT, Point(0, 0), 320);
+    });
+    printf("\n%s, %d pixel lines: %.1f\n", argv[1], loaded->line_height, aa_us);
+    delete loaded;
+  }
+
+  return 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// The DMA registers and calls the display drivers use, doing nothing
+#include "pico/stdlib.h"
+
+typedef struct {
+  volatile uintptr_t read_addr;
+  volatile uintptr_t write_addr;
+  volatile uint32_t transfer_count;
+  volatile uint32_t ctrl_trig;
+  volatile uint32_t al1_ctrl;
+} dma_channel_hw_t;
+
+typedef struct {
+  dma_channel_hw_t ch[12];
+} dma_hw_t;
+
+inline dma_hw_t host_dma_hw;
+#define dma_hw (&host_dma_hw)
+
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS 0x00007800u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB 11
+#define DREQ_FORCE 0x3f
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+typedef struct {
+  uint32_t ctrl;
+} dma_channel_config;
+
+static inline dma_channel_config dma_channel_get_default_config(uint) { return {0}; }
+static inline void channel_config_set_transfer_data_size(dma_channel_config *, enum dma_channel_transfer_size) {}
+static inline void channel_config_set_read_increment(dma_channel_config *, bool) {}
+static inline void channel_config_set_write_increment(dma_channel_config *, bool) {}
+static inline void channel_config_set_ring(dma_channel_config *, bool, uint) {}
+static inline void channel_config_set_dreq(dma_channel_config *, uint) {}
+static inline void channel_config_set_chain_to(dma_channel_config *, uint) {}
+static inline uint32_t channel_config_get_ctrl_value(const dma_channel_config *c) { return c->ctrl; }
+
+static inline void dma_channel_configure(uint, const dma_channel_config *, volatile void *, const volatile void *, uint, bool) {}
+static inline void dma_channel_claim(uint) {}
+static inline void dma_channel_unclaim(uint) {}
+static inline bool dma_channel_is_claimed(uint) { return false; }
+static inline void dma_channel_abort(uint) {}
@@ -0,0 +1,3 @@
+#pragma once
+
+typedef void (*irq_handler_t)(void);
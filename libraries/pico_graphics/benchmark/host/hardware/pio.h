@@ -0,0 +1,33 @@
+#pragma once
+
+// The PIO calls the display drivers use, doing nothing
+#include "pico/stdlib.h"
+
+typedef struct {
+  volatile uint32_t txf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+inline pio_hw_t host_pio0_hw;
+#define pio0 (&host_pio0_hw)
+
+typedef struct {
+  const uint16_t *instructions;
+} pio_program_t;
+
+enum pio_src_dest { pio_pins = 0, pio_x = 1, pio_y = 2, pio_null = 3 };
+
+static inline uint16_t pio_encode_pull(bool if_empty, bool block) { return 0x8080 | (if_empty << 6) | (block << 5); }
+static inline uint16_t pio_encode_out(enum pio_src_dest dest, uint count) { return 0x6000 | (dest << 5) | (count & 31); }
+
+static inline uint pio_get_dreq(PIO, uint sm, bool) { return sm; }
+static inline void pio_sm_claim(PIO, uint) {}
+static inline void pio_sm_unclaim(PIO, uint) {}
+static inline bool pio_sm_is_claimed(PIO, uint) { return false; }
+static inline uint pio_add_program(PIO, const pio_program_t *) { return 0; }
+static inline void pio_clear_instruction_memory(PIO) {}
+static inline void pio_interrupt_clear(PIO, uint) {}
+static inline void pio_sm_set_enabled(PIO, uint, bool) {}
+static inline void pio_sm_drain_tx_fifo(PIO, uint) {}
+static inline void pio_sm_set_clkdiv(PIO, uint, float) {}
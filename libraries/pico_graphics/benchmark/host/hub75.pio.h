@@ -0,0 +1,15 @@
+#pragma once
+
+// Stands in for the header pioasm generates from drivers/hub75/hub75.pio
+#include "hardware/pio.h"
+
+static const pio_program_t hub75_data_rgb888_program = {nullptr};
+static const pio_program_t hub75_row_program = {nullptr};
+static const pio_program_t hub75_row_inverted_program = {nullptr};
+
+static inline void hub75_data_rgb888_program_init(PIO, uint, uint, uint, uint) {}
+static inline void hub75_row_program_init(PIO, uint, uint, uint, uint, uint) {}
+
+static inline uint16_t hub75_data_rgb888_shift_instr(uint shamt) {
+  return shamt == 0 ? pio_encode_pull(false, true) : pio_encode_out(pio_null, shamt);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Just enough of the Pico SDK for PicoGraphics to build on a desktop machine
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+
+typedef unsigned int uint;
+
+typedef uint64_t absolute_time_t;
+
+static inline absolute_time_t get_absolute_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+  return t / 1000;
+}
+
+static inline uint64_t time_us_64() {
+  return get_absolute_time();
+}
+
+static inline void sleep_us(uint64_t) {}
+static inline void tight_loop_contents() {}
+
+// drivers only drive their pins from start(), which the benchmarks never call
+#define GPIO_FUNC_SIO 5
+
+static inline void gpio_init(uint) {}
+static inline void gpio_set_function(uint, uint) {}
+static inline void gpio_set_dir(uint, bool) {}
+static inline void gpio_put(uint, bool) {}
+static inline void gpio_put_masked(uint32_t, uint32_t) {}
@@ -0,0 +1,120 @@
+// Times Hub75::update() converting a PicoGraphics frame into the interleaved
+// buffer the panel is refreshed from, against calling set_pixel() for every
+// pixel the way update() used to.
+//
+// Each source format is converted for a 256x64 chain of four panels and for
+// the same panels arranged as a 2x2 serpentine grid. Dithering is left off
+// so both paths have to write exactly the same pixels, and any difference is
+// reported. The PIO, DMA and GPIO calls are stubbed out in host/, so nothing
+// is refreshed.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "drivers/hub75/hub75.hpp"
+
+using namespace pimoroni;
+
+// the pixel at a time conversion update() replaced
+static void update_per_pixel(Hub75 &hub75, PicoGraphics *graphics, uint width, uint height) {
+  for(auto y = 0u; y < height; y++) {
+    for(auto x = 0u; x < width; x++) {
+      auto i = y * width + x;
+      switch(graphics->pen_type) {
+        case PicoGraphics::PEN_RGB888: {
+          uint32_t col = ((uint32_t *)graphics->frame_buffer)[i];
+          hub75.set_pixel(x, y, (col >> 16) & 0xff, (col >> 8) & 0xff, col & 0xff);
+          break;
+        }
+        case PicoGraphics::PEN_RGB565: {
+          uint16_t col = __builtin_bswap16(((uint16_t *)graphics->frame_buffer)[i]);
+          hub75.set_pixel(x, y, (col & 0b1111100000000000) >> 8, (col & 0b0000011111100000) >> 3, (col & 0b0000000000011111) << 3);
+          break;
+        }
+        default: {
+          uint8_t index = ((uint8_t *)graphics->frame_buffer)[i];
+          RGB c = graphics->pen_type == PicoGraphics::PEN_P8 ? graphics->get_palette()[index] : RGB((RGB332)index);
+          hub75.set_pixel(x, y, c.r, c.g, c.b);
+          break;
+        }
+      }
+    }
+  }
+}
+
+template<typename F>
+static double time_us(F convert) {
+  const int runs = 200;
+  double best = 1e9;
+  for(int i = 0; i < 5; i++) {
+    auto start = std::chrono::steady_clock::now();
+    for(int j = 0; j < runs; j++) convert();
+    std::chrono::duration<double, std::micro> t = std::chrono::steady_clock::now() - start;
+    best = std::min(best, t.count() / runs);
+  }
+  return best;
+}
+
+int main() {
+  const uint WIDTH = 256;
+  const uint HEIGHT = 64;
+
+  std::mt19937 rng(1);
+  std::vector<uint32_t> rgb888(WIDTH * HEIGHT);
+  std::vector<uint16_t> rgb565(WIDTH * HEIGHT);
+  std::vector<uint8_t> indexed(WIDTH * HEIGHT);
+  for(auto &p : rgb888) p = rng() & 0xffffff;
+  for(auto &p : rgb565) p = rng();
+  for(auto &p : indexed) p = rng();
+
+  PicoGraphics_PenRGB888 graphics_rgb888(WIDTH, HEIGHT, rgb888.data());
+  PicoGraphics_PenRGB565 graphics_rgb565(WIDTH, HEIGHT, rgb565.data());
+  PicoGraphics_PenRGB332 graphics_rgb332(WIDTH, HEIGHT, indexed.data());
+  PicoGraphics_PenP8 graphics_p8(WIDTH, HEIGHT, indexed.data());
+  for(auto i = 0u; i < 256; i++) {
+    graphics_p8.update_pen(i, rng(), rng(), rng());
+  }
+
+  struct {
+    const char *name;
+    PicoGraphics *graphics;
+  } sources[] = {
+    {"rgb888", &graphics_rgb888},
+    {"rgb565", &graphics_rgb565},
+    {"rgb332", &graphics_rgb332},
+    {"p8", &graphics_p8}
+  };
+
+  printf("microseconds per frame, %ux%u canvas of 64x64 panels\n\n", WIDTH, HEIGHT);
+  printf("source  layout  per pixel    update  speedup\n");
+
+  int mismatches = 0;
+  for(bool grid : {false, true}) {
+    // the grid canvas holds the same four panels as a square
+    uint width = grid ? WIDTH / 2 : WIDTH;
+    uint height = grid ? HEIGHT * 2 : HEIGHT;
+    Hub75 expected(width, height, nullptr, PANEL_GENERIC, false, Hub75::COLOR_ORDER::GRB);
+    Hub75 actual(width, height, nullptr, PANEL_GENERIC, false, Hub75::COLOR_ORDER::GRB);
+    if(grid && !(expected.set_grid_layout(64, 64, 2, 2, true) && actual.set_grid_layout(64, 64, 2, 2, true))) {
+      printf("couldn't set the grid layout\n");
+      return 1;
+    }
+
+    for(auto &s : sources) {
+      update_per_pixel(expected, s.graphics, width, height);
+      actual.update(s.graphics);
+      if(memcmp(expected.back_buffer, actual.back_buffer, WIDTH * HEIGHT * sizeof(Pixel)) != 0) {
+        printf("%s %s: update() differs from set_pixel()\n", s.name, grid ? "grid" : "chain");
+        mismatches++;
+      }
+
+      double per_pixel = time_us([&]() { update_per_pixel(expected, s.graphics, width, height); });
+      double update = time_us([&]() { actual.update(s.graphics); });
+      printf("%-6s  %-6s  %9.1f  %8.1f  %6.1fx\n", s.name, grid ? "grid" : "chain", per_pixel, update, per_pixel / update);
+    }
+  }
+
+  return mismatches ? 1 : 0;
+}
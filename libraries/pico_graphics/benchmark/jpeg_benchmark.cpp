@@ -0,0 +1,199 @@
+// Times JPEGGraphics drawing a 320x240 JPEG into each of the pen types that
+// take RGB565 from JPEGDEC, against the pixel at a time callback it replaced.
+//
+// "decode" times JPEGDEC alone with a callback that does nothing, so the
+// draw cost is the difference between it and the other two columns. The test
+// image is generated at startup and compressed with libjpeg: a gradient with
+// circles on it, at 4:2:0 like most camera images. Pass a JPEG to time that
+// instead:
+//
+//   jpeg_benchmark image.jpg
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "libraries/jpegdec/jpeg_graphics.hpp"
+
+// both headers define DCTSIZE as 64
+#undef DCTSIZE
+#include <jpeglib.h>
+
+using namespace pimoroni;
+
+static const int32_t WIDTH = 320;
+static const int32_t HEIGHT = 240;
+
+static std::vector<uint8_t> make_jpeg() {
+  std::vector<uint8_t> pixels(WIDTH * HEIGHT * 3);
+  for(int32_t y = 0; y < HEIGHT; y++) {
+    for(int32_t x = 0; x < WIDTH; x++) {
+      uint8_t *p = &pixels[(x + y * WIDTH) * 3];
+      p[0] = x * 255 / WIDTH;
+      p[1] = y * 255 / HEIGHT;
+      p[2] = 128;
+
+      for(int i = 0; i < 6; i++) {
+        float cx = 40 + (i % 3) * 120, cy = 60 + (i / 3) * 120;
+        if(sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy)) < 50.0f) {
+          p[0] = 255 - i * 40;
+          p[1] = i * 40;
+          p[2] = 64;
+        }
+      }
+    }
+  }
+
+  jpeg_compress_struct cinfo;
+  jpeg_error_mgr jerr;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+
+  unsigned char *data = nullptr;
+  unsigned long length = 0;
+  jpeg_mem_dest(&cinfo, &data, &length);
+  cinfo.image_width = WIDTH;
+  cinfo.image_height = HEIGHT;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, 85, TRUE);
+  jpeg_start_compress(&cinfo, TRUE);
+  while(cinfo.next_scanline < cinfo.image_height) {
+    JSAMPROW row = &pixels[cinfo.next_scanline * WIDTH * 3];
+    jpeg_write_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+
+  std::vector<uint8_t> jpeg(data, data + length);
+  free(data);
+  return jpeg;
+}
+
+template<typename F>
+static double time_ms(F decode) {
+  const int runs = 20;
+  double best = 1e9;
+  for(int i = 0; i < 3; i++) {
+    auto start = std::chrono::steady_clock::now();
+    for(int j = 0; j < runs; j++) decode();
+    std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - start;
+    best = std::min(best, t.count() / runs);
+  }
+  return best;
+}
+
+struct PerPixel {
+  PicoGraphics *graphics;
+  bool dither;
+};
+
+// the pixel at a time draw callback that JPEGGraphics replaced, for RGB565 output
+static int draw_per_pixel(JPEGDRAW *draw) {
+  PerPixel *target = (PerPixel *)draw->pUser;
+  PicoGraphics *graphics = target->graphics;
+  for(int y = 0; y < draw->iHeight; y++) {
+    for(int x = 0; x < draw->iWidthUsed; x++) {
+      RGB565 c = draw->pPixels[y * draw->iWidth + x];
+      Point p(draw->x + x, draw->y + y);
+      switch(graphics->pen_type) {
+        case PicoGraphics::PEN_RGB332:
+          if(target->dither) {
+            graphics->set_pixel_dither(p, c);
+            continue;
+          }
+          graphics->set_pen(RGB(c).to_rgb332());
+          break;
+        case PicoGraphics::PEN_RGB888:
+          graphics->set_pen(RGB(c).to_rgb888());
+          break;
+        case PicoGraphics::PEN_P8:
+          if(target->dither) {
+            graphics->set_pixel_dither(p, RGB(c));
+            continue;
+          } else {
+            int closest = RGB(c).closest(graphics->get_palette(), graphics->get_palette_size());
+            graphics->set_pen(closest == -1 ? 0 : closest);
+          }
+          break;
+        default:
+          graphics->set_pen(c);
+          break;
+      }
+      graphics->pixel(p);
+    }
+  }
+  return 1;
+}
+
+static JPEGDEC jpeg;
+
+static bool benchmark(const char *name, std::vector<uint8_t> &data, PicoGraphics &graphics, bool dither) {
+  if(!jpeg.openRAM(data.data(), data.size(), JPEGGraphics::draw)) {
+    fprintf(stderr, "%s: not a JPEG\n", name);
+    return false;
+  }
+  double pixels = double(jpeg.getWidth()) * jpeg.getHeight();
+
+  double decode_ms = time_ms([&]() {
+    jpeg.openRAM(data.data(), data.size(), [](JPEGDRAW *) { return 1; });
+    jpeg.setPixelType(RGB565_BIG_ENDIAN);
+    jpeg.decode(0, 0, 0);
+  });
+
+  PerPixel per_pixel_target = {&graphics, dither};
+  double per_pixel_ms = time_ms([&]() {
+    jpeg.openRAM(data.data(), data.size(), draw_per_pixel);
+    jpeg.setPixelType(RGB565_BIG_ENDIAN);
+    jpeg.setUserPointer(&per_pixel_target);
+    jpeg.decode(0, 0, 0);
+  });
+
+  JPEGGraphics target(&graphics, dither ? 0 : JPEGGraphics::NO_DITHER);
+  int result = 1;
+  double rows_ms = time_ms([&]() {
+    jpeg.openRAM(data.data(), data.size(), JPEGGraphics::draw);
+    result = target.decode(jpeg, {0, 0});
+  });
+  if(!result) {
+    fprintf(stderr, "%s: decode failed (%d)\n", name, jpeg.getLastError());
+    return false;
+  }
+
+  printf("%-16s %7.2f  %9.2f  %12.2f  %8.1f\n", name, decode_ms, per_pixel_ms, rows_ms,
+         pixels / rows_ms / 1000.0);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<uint8_t> data;
+  if(argc > 1) {
+    std::ifstream f(argv[1], std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  } else {
+    data = make_jpeg();
+  }
+
+  // big enough for the test image, larger images are clipped
+  PicoGraphics_PenRGB565 rgb565(WIDTH, HEIGHT, nullptr);
+  PicoGraphics_PenRGB888 rgb888(WIDTH, HEIGHT, nullptr);
+  PicoGraphics_PenRGB332 rgb332(WIDTH, HEIGHT, nullptr);
+  PicoGraphics_PenP8 p8(WIDTH, HEIGHT, nullptr);
+  for(int i = 0; i < 256; i++) {
+    p8.update_pen(i, (i >> 5) * 255 / 7, ((i >> 2) & 7) * 255 / 7, (i & 3) * 255 / 3);
+  }
+
+  printf("milliseconds per %zu byte JPEG drawn into a %dx%d buffer\n\n", data.size(), WIDTH, HEIGHT);
+  printf("pen               decode  per pixel  JPEGGraphics  Mpixel/s\n");
+
+  bool ok = benchmark("rgb565", data, rgb565, true)
+         && benchmark("rgb888", data, rgb888, true)
+         && benchmark("rgb332", data, rgb332, true)
+         && benchmark("rgb332 no dither", data, rgb332, false)
+         && benchmark("p8", data, p8, true)
+         && benchmark("p8 no dither", data, p8, false);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+// Times PNGDecoder decoding a 480x800 image into an RGB565 buffer, from
+// memory and through a read callback the way a FatFS file would be read.
+//
+// The test images are generated at startup and compressed with zlib: a
+// gradient with anti-aliased translucent circles on it, as RGBA, RGB and an
+// 8-bit palette image. Every row uses one of the five PNG filters in turn so
+// all of the unfiltering paths are timed. Pass a PNG to time that instead:
+//
+//   png_benchmark image.png
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <zlib.h>
+
+#include "libraries/pngdec/pngdec.hpp"
+
+using namespace pimoroni;
+
+static const int32_t WIDTH = 480;
+static const int32_t HEIGHT = 800;
+
+static void put_u32(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+static void put_chunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+  put_u32(out, data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  put_u32(out, crc32(0, &out[start], out.size() - start));
+}
+
+static uint8_t paeth(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+// pixels holds bpp bytes per pixel in the PNG sample order
+static std::vector<uint8_t> encode(const std::vector<uint8_t> &pixels, uint8_t color_type, int bpp,
+                                   const std::vector<uint8_t> &palette = {}) {
+  size_t stride = WIDTH * bpp;
+  std::vector<uint8_t> raw;
+  std::vector<uint8_t> zero(stride, 0);
+  for(int32_t y = 0; y < HEIGHT; y++) {
+    const uint8_t *row = &pixels[y * stride];
+    const uint8_t *prev = y ? row - stride : zero.data();
+    uint8_t filter = y % 5;
+    raw.push_back(filter);
+    for(size_t i = 0; i < stride; i++) {
+      int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+      int b = prev[i];
+      int c = i >= (size_t)bpp ? prev[i - bpp] : 0;
+      int predict[] = {0, a, b, (a + b) / 2, paeth(a, b, c)};
+      raw.push_back(row[i] - predict[filter]);
+    }
+  }
+
+  uLongf length = compressBound(raw.size());
+  std::vector<uint8_t> idat(length);
+  compress2(idat.data(), &length, raw.data(), raw.size(), 6);
+  idat.resize(length);
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  std::vector<uint8_t> ihdr;
+  put_u32(ihdr, WIDTH);
+  put_u32(ihdr, HEIGHT);
+  ihdr.insert(ihdr.end(), {8, color_type, 0, 0, 0});
+  put_chunk(png, "IHDR", ihdr);
+  if(!palette.empty()) put_chunk(png, "PLTE", palette);
+
+  // split the data the way encoders usually do so chunk boundaries are crossed
+  for(size_t i = 0; i < idat.size(); i += 8192) {
+    put_chunk(png, "IDAT", std::vector<uint8_t>(idat.begin() + i, idat.begin() + std::min(idat.size(), i + 8192)));
+  }
+  put_chunk(png, "IEND", {});
+  return png;
+}
+
+// RGBA test image, a gradient with translucent circles whose edges are smoothed
+static std::vector<uint8_t> make_rgba() {
+  std::vector<uint8_t> pixels(WIDTH * HEIGHT * 4);
+  for(int32_t y = 0; y < HEIGHT; y++) {
+    for(int32_t x = 0; x < WIDTH; x++) {
+      uint8_t *p = &pixels[(x + y * WIDTH) * 4];
+      p[0] = x * 255 / WIDTH;
+      p[1] = y * 255 / HEIGHT;
+      p[2] = 128;
+      p[3] = 255;
+
+      for(int i = 0; i < 12; i++) {
+        float cx = 40 + (i % 3) * 200, cy = 60 + (i / 3) * 200;
+        float d = sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy));
+        float coverage = std::max(0.0f, std::min(1.0f, 60.0f - d));
+        if(coverage > 0.0f) {
+          p[0] = 255 - i * 20;
+          p[1] = i * 20;
+          p[2] = 64;
+          p[3] = uint8_t(coverage * 192);
+        }
+      }
+    }
+  }
+  return pixels;
+}
+
+static std::vector<uint8_t> make_rgb(const std::vector<uint8_t> &rgba) {
+  std::vector<uint8_t> pixels;
+  for(size_t i = 0; i < rgba.size(); i += 4) pixels.insert(pixels.end(), &rgba[i], &rgba[i] + 3);
+  return pixels;
+}
+
+// 3-3-2 bit palette so the image has plenty of distinct indices
+static std::vector<uint8_t> make_palette(const std::vector<uint8_t> &rgba, std::vector<uint8_t> &palette) {
+  palette.clear();
+  for(int i = 0; i < 256; i++) {
+    palette.insert(palette.end(), {uint8_t((i >> 5) * 255 / 7), uint8_t(((i >> 2) & 7) * 255 / 7), uint8_t((i & 3) * 255 / 3)});
+  }
+  std::vector<uint8_t> pixels;
+  for(size_t i = 0; i < rgba.size(); i += 4) {
+    pixels.push_back((rgba[i] & 0xe0) | ((rgba[i + 1] >> 3) & 0x1c) | (rgba[i + 2] >> 6));
+  }
+  return pixels;
+}
+
+template<typename F>
+static double time_ms(F decode) {
+  const int runs = 10;
+  double best = 1e9;
+  for(int i = 0; i < 3; i++) {
+    auto start = std::chrono::steady_clock::now();
+    for(int j = 0; j < runs; j++) decode();
+    std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - start;
+    best = std::min(best, t.count() / runs);
+  }
+  return best;
+}
+
+static bool benchmark(const char *name, const std::vector<uint8_t> &png, PicoGraphics &graphics) {
+  PNGDecoder decoder;
+  if(!decoder.open(png.data(), png.size())) {
+    fprintf(stderr, "%s: not a PNG\n", name);
+    return false;
+  }
+  double pixels = double(decoder.get_width()) * decoder.get_height();
+
+  PNGDecoder::Result result = PNGDecoder::PNG_OK;
+  double memory_ms = time_ms([&]() {
+    decoder.open(png.data(), png.size());
+    result = decoder.decode(&graphics, Point(0, 0));
+  });
+  if(result != PNGDecoder::PNG_OK) {
+    fprintf(stderr, "%s: decode failed (%d)\n", name, result);
+    return false;
+  }
+
+  double stream_ms = time_ms([&]() {
+    size_t position = 0;
+    decoder.open([&](uint8_t *buffer, int32_t length) -> int32_t {
+      int32_t n = std::min<size_t>(length, png.size() - position);
+      memcpy(buffer, &png[position], n);
+      position += n;
+      return n;
+    });
+    decoder.decode(&graphics, Point(0, 0));
+  });
+
+  double rows_ms = time_ms([&]() {
+    decoder.open(png.data(), png.size());
+    decoder.decode([](int32_t, int32_t, int32_t, const uint8_t *, int32_t) {});
+  });
+
+  printf("%-10s %8zu  %9.2f  %9.2f  %9.2f  %8.1f\n", name, png.size(),
+         memory_ms, stream_ms, rows_ms, pixels / memory_ms / 1000.0);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  static uint16_t buffer[WIDTH * HEIGHT];
+  PicoGraphics_PenRGB565 graphics(WIDTH, HEIGHT, buffer);
+
+  printf("milliseconds per decode into a %dx%d RGB565 buffer\n\n", WIDTH, HEIGHT);
+  printf("image         bytes     memory     stream  rows only  Mpixel/s\n");
+
+  if(argc > 1) {
+    std::ifstream f(argv[1], std::ios::binary);
+    std::vector<uint8_t> png((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    return benchmark(argv[1], png, graphics) ? 0 : 1;
+  }
+
+  std::vector<uint8_t> rgba = make_rgba();
+  std::vector<uint8_t> palette;
+  std::vector<uint8_t> indexed = make_palette(rgba, palette);
+
+  bool ok = benchmark("rgba", encode(rgba, PNGDecoder::COLOR_RGBA, 4), graphics)
+         && benchmark("rgb", encode(make_rgb(rgba), PNGDecoder::COLOR_RGB, 3), graphics)
+         && benchmark("palette", encode(indexed, PNGDecoder::COLOR_PALETTE, 1, palette), graphics);
+  return ok ? 0 : 1;
+}
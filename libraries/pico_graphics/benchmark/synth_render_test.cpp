@@ -0,0 +1,130 @@
+// Checks that PicoSynth::render() produces exactly the same samples as
+// calling get_audio_frame() once per sample, and leaves the synth in the
+// same state. Each trial randomises every channel, then plays both synths
+// through the same notes and parameter changes, rendering in blocks of
+// random length between them. Every tenth trial refills WAVE buffers from a
+// callback. Exits non-zero on the first difference.
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "libraries/pico_synth/pico_synth.hpp"
+
+using namespace pimoroni;
+
+namespace pimoroni {
+  // noise generator state, shared by every synth
+  extern uint32_t prng_xorshift_state;
+}
+
+struct Event {
+  size_t frame;
+  uint channel;
+  uint kind;
+  uint16_t value;
+};
+
+static void randomise(PicoSynth &synth, std::mt19937 &rng) {
+  synth.volume = rng() % 4 == 0 ? 0xffff : rng() & 0xffff;
+  for(auto &c : synth.channels) {
+    c.waveforms = rng() % 5 == 0 ? 0 : rng() & (NOISE | SQUARE | SAW | TRIANGLE | SINE);
+    if(rng() % 6 == 0) c.waveforms |= WAVE;
+    c.frequency = rng() % 8 == 0 ? rng() & 0xffff : rng() % 4000;
+    c.volume = rng() % 3 == 0 ? 0xffff : rng() & 0xffff;
+    c.attack_ms = 1 + rng() % 30;
+    c.decay_ms = 1 + rng() % 30;
+    c.sustain = rng() & 0xffff;
+    c.release_ms = 1 + rng() % 30;
+    c.pulse_width = rng() & 0xffff;
+    c.wave_buffer_callback = nullptr;
+    for(auto &w : c.wave_buffer) w = rng();
+
+    // start some channels part way through a note
+    if(rng() % 20 == 0) {
+      c.adsr_level = rng();
+      c.adsr_phase = ADSRPhase::SUSTAIN;
+    }
+  }
+}
+
+static void apply(PicoSynth &synth, const Event &e) {
+  AudioChannel &c = synth.channels[e.channel];
+  switch(e.kind) {
+    case 0: c.trigger_attack(); break;
+    case 1: c.trigger_release(); break;
+    case 2: c.frequency = e.value; break;
+    case 3: c.waveforms = e.value & (NOISE | SQUARE | SAW | TRIANGLE | SINE); break;
+    case 4: c.volume = e.value; break;
+  }
+}
+
+static void refill(AudioChannel &c) {
+  for(auto &w : c.wave_buffer) w = w * 3 + 1;
+  c.frequency += 7;
+}
+
+int main() {
+  const int trials = 500;
+  size_t frames = 0;
+
+  for(int trial = 0; trial < trials; trial++) {
+    std::mt19937 rng(trial);
+
+    static PicoSynth expected, actual;
+    expected = PicoSynth();
+    randomise(expected, rng);
+    if(trial % 10 == 0) {
+      for(auto &c : expected.channels) {
+        if(c.waveforms & WAVE) c.wave_buffer_callback = refill;
+      }
+    }
+    // a byte copy, so padding matches when the channels are compared
+    memcpy((void *)&actual, (void *)&expected, sizeof(actual));
+
+    size_t length = 2000 + rng() % 20000;
+    std::vector<Event> events;
+    for(size_t frame = 0; frame < length; frame += 1 + rng() % 600) {
+      uint16_t value = rng() % 5 == 0 ? rng() : rng() % 3000;
+      events.push_back({frame, uint(rng() % PicoSynth::CHANNEL_COUNT), uint(rng() % 5), value});
+    }
+
+    std::vector<int16_t> expected_samples(length), actual_samples(length);
+    uint32_t seed = rng();
+
+    prng_xorshift_state = seed;
+    size_t e = 0;
+    for(size_t frame = 0; frame < length; frame++) {
+      while(e < events.size() && events[e].frame == frame) apply(expected, events[e++]);
+      expected_samples[frame] = expected.get_audio_frame();
+    }
+    uint32_t expected_prng = prng_xorshift_state;
+
+    prng_xorshift_state = seed;
+    e = 0;
+    for(size_t frame = 0; frame < length;) {
+      while(e < events.size() && events[e].frame == frame) apply(actual, events[e++]);
+      size_t next = e < events.size() ? events[e].frame : length;
+      size_t count = std::min(next - frame, size_t(1 + rng() % 300));
+      actual.render(&actual_samples[frame], count);
+      frame += count;
+    }
+
+    if(expected_samples != actual_samples) {
+      size_t i = 0;
+      while(expected_samples[i] == actual_samples[i]) i++;
+      printf("FAIL trial %d: frame %zu is %d, expected %d\n", trial, i, actual_samples[i], expected_samples[i]);
+      return 1;
+    }
+    if(prng_xorshift_state != expected_prng
+       || memcmp((void *)expected.channels, (void *)actual.channels, sizeof(expected.channels)) != 0) {
+      printf("FAIL trial %d: synth state differs after the last frame\n", trial);
+      return 1;
+    }
+    frames += length;
+  }
+
+  printf("%d trials, %zu frames rendered identically\n", trials, frames);
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Characters per second for the bitmap fonts, drawn into a 320x240 RGB565
+// buffer at scales 1 to 3.
+//
+// "glyphs" times bitmap::character() alone with a callback that does
+// nothing, "drawn" times PicoGraphics::text() filling the spans. "per bit"
+// splits every span back into one scale x scale rectangle per set bit, the
+// way glyphs were drawn before they were merged into spans, for comparison.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+using namespace pimoroni;
+
+static const std::string TEXT = "The quick brown fox jumps over the lazy dog. "
+                                "Pack my box with five dozen liquor jugs! 0123456789";
+
+template<typename F>
+static double chars_per_second(F draw) {
+  const int runs = 200;
+  double best = 1e9;
+  for(int i = 0; i < 5; i++) {
+    auto start = std::chrono::steady_clock::now();
+    for(int j = 0; j < runs; j++) draw();
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    best = std::min(best, t.count() / runs);
+  }
+  return TEXT.size() / best;
+}
+
+int main() {
+  static uint16_t buffer[320 * 240];
+  PicoGraphics_PenRGB565 graphics(320, 240, buffer);
+  graphics.set_pen(255, 255, 255);
+
+  struct {
+    const char *name;
+    const bitmap::font_t *font;
+  } fonts[] = {
+    {"font6", &font6},
+    {"font8", &font8},
+    {"font14_outline", &font14_outline}
+  };
+
+  printf("%zu characters wrapped to 320 pixels, thousands of characters per second\n\n", TEXT.size());
+  printf("font            scale   glyphs    drawn  per bit\n");
+
+  for(auto &f : fonts) {
+    for(uint8_t scale = 1; scale <= 3; scale++) {
+      volatile int32_t sink = 0;
+      double glyphs = chars_per_second([&]() {
+        bitmap::text(f.font, [&](int32_t x, int32_t y, int32_t w, int32_t h) {
+          sink = sink + w;
+        }, TEXT, 0, 0, 320, scale);
+      });
+
+      graphics.set_font(f.font);
+      double drawn = chars_per_second([&]() {
+        graphics.text(TEXT, Point(0, 0), 320, scale);
+      });
+
+      double per_bit = chars_per_second([&]() {
+        bitmap::text(f.font, [&](int32_t x, int32_t y, int32_t w, int32_t h) {
+          for(int32_t cy = y; cy < y + h; cy += scale)
+            for(int32_t cx = x; cx < x + w; cx += scale)
+              graphics.rectangle(Rect(cx, cy, scale, scale));
+        }, TEXT, 0, 0, 320, scale);
+      });
+
+      printf("%-14s  %5d  %7.0f  %7.0f  %7.0f\n", f.name, scale, glyphs / 1000.0, drawn / 1000.0, per_bit / 1000.0);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+// Checks that drawing a TextLayout gives exactly the same pixels as
+// PicoGraphics::text() for the bitmap fonts, over a spread of wrap widths,
+// scales and awkward strings. Hershey fonts are compared without wrapping,
+// since text() doesn't wrap them. Exits non-zero on any difference.
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+using namespace pimoroni;
+
+static const int WIDTH = 320;
+static const int HEIGHT = 240;
+
+static const char *STRINGS[] = {
+  "The quick brown fox jumps over the lazy dog.",
+  "  leading spaces and  double  spaces ",
+  "one\nnewline and a\n\nblank line\n",
+  "\nstarts with a newline",
+  "averyveryverylongwordthatwillnotfitonanylineatall then short",
+  "a b c d e f g h i j k l m n o p q r s t u v w x y z",
+  "caf\xc3\xa9 \xc3\xbc""ber \xc2\xa3""5 na\xc3\xaf""ve",
+  "",
+  " ",
+};
+
+static uint16_t expected[WIDTH * HEIGHT];
+static uint16_t actual[WIDTH * HEIGHT];
+
+template<typename F>
+static void draw(uint16_t *buffer, F f) {
+  PicoGraphics_PenRGB565 graphics(WIDTH, HEIGHT, buffer);
+  graphics.set_pen(0);
+  graphics.clear();
+  graphics.set_pen(255, 255, 255);
+  f(graphics);
+}
+
+int main() {
+  const bitmap::font_t *fonts[] = {&font6, &font8, &font14_outline};
+  const int32_t wraps[] = {-1, 0, 1, 40, 100, 200, WIDTH};
+  int checks = 0, failures = 0;
+
+  for(auto font : fonts) {
+    for(float scale = 1.0f; scale <= 3.0f; scale++) {
+      for(auto wrap : wraps) {
+        for(auto s : STRINGS) {
+          draw(expected, [&](PicoGraphics &g) {
+            g.set_font(font);
+            g.text(s, Point(4, 20), wrap, scale);
+          });
+          draw(actual, [&](PicoGraphics &g) {
+            g.set_font(font);
+            g.text(g.layout_text(s, wrap, scale), Point(4, 20));
+          });
+          checks++;
+          if(memcmp(expected, actual, sizeof(expected)) != 0) {
+            printf("FAIL bitmap height %d, scale %g, wrap %d: \"%s\"\n", font->height, scale, wrap, s);
+            failures++;
+          }
+        }
+      }
+    }
+  }
+
+  for(float scale : {0.5f, 1.0f}) {
+    for(auto s : STRINGS) {
+      if(strchr(s, '\n')) continue;
+      draw(expected, [&](PicoGraphics &g) {
+        g.set_font("sans");
+        g.text(s, Point(4, 100), -1, scale);
+      });
+      draw(actual, [&](PicoGraphics &g) {
+        g.set_font("sans");
+        g.text(g.layout_text(s, -1, scale), Point(4, 100));
+      });
+      checks++;
+      if(memcmp(expected, actual, sizeof(expected)) != 0) {
+        printf("FAIL hershey scale %g: \"%s\"\n", scale, s);
+        failures++;
+      }
+    }
+  }
+
+  printf("%d of %d layouts match text()\n", checks - failures, checks);
+  return failures ? 1 : 0;
+}
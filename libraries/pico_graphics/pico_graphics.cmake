@@ -2,6 +2,10 @@ if(NOT TARGET bitmap_fonts)
     include(${CMAKE_CURRENT_LIST_DIR}/../bitmap_fonts/bitmap_fonts.cmake)
 endif()
 
+if(NOT TARGET aa_fonts)
+    include(${CMAKE_CURRENT_LIST_DIR}/../aa_fonts/aa_fonts.cmake)
+endif()
+
 if(NOT TARGET hershey_fonts)
     include(${CMAKE_CURRENT_LIST_DIR}/../hershey_fonts/hershey_fonts.cmake)
 endif()
@@ -18,8 +22,10 @@ add_library(pico_graphics
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_pen_rgb565.cpp
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_pen_rgb888.cpp
     ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_pen_inky7.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_compositor.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/pico_graphics_text_layout.cpp
 )
 
 target_include_directories(pico_graphics INTERFACE ${CMAKE_CURRENT_LIST_DIR})
 
-target_link_libraries(pico_graphics bitmap_fonts hershey_fonts pico_stdlib)
\ No newline at end of file
+target_link_libraries(pico_graphics bitmap_fonts aa_fonts hershey_fonts pico_stdlib)
\ No newline at end of file
@@ -11,8 +11,55 @@ namespace pimoroni {
   void PicoGraphics::set_pixel_dither(const Point &p, const RGB &c) {};
   void PicoGraphics::set_pixel_dither(const Point &p, const RGB565 &c) {};
   void PicoGraphics::set_pixel_dither(const Point &p, const uint8_t &c) {};
+
+  // Pens that can't blend fall back to drawing anything at least half covered
+  void PicoGraphics::set_pixel_span_alpha(const Point &p, uint l, uint8_t a) {
+    if(a >= 128) set_pixel_span(p, l);
+  };
+  // Pens that can't blend per pixel draw each run of equal coverage as a span
+  void PicoGraphics::set_pixel_span_coverage(const Point &p, uint l, const uint8_t *coverage) {
+    Point o = p;
+    while(l) {
+      uint8_t a = *coverage;
+      uint run = 1;
+      while(run < l && coverage[run] == a) run++;
+      if(a == 255) {
+        set_pixel_span(o, run);
+      } else if(a) {
+        set_pixel_span_alpha(o, run, a);
+      }
+      o.x += run;
+      coverage += run;
+      l -= run;
+    }
+  };
+  // Pens without a batched converter go a pixel at a time, 1-bit pens
+  // always dither their 16 shades of grey so take each pixel as a pen colour.
+  // Palette pens such as 3Bit and Inky7 dither any RGB pen, so without
+  // dithering they're given the closest palette entry instead
+  void PicoGraphics::set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) {
+    const RGB *palette = get_palette();
+    int palette_size = get_palette_size();
+    Point o = p;
+    while(l--) {
+      RGB c(*data++);
+      if(dither && pen_type != PEN_1BIT) {
+        set_pixel_dither(o, c);
+      } else {
+        if(palette && palette_size > 0) {
+          set_pen(c.closest(palette, palette_size));
+        } else {
+          set_pen(c.r, c.g, c.b);
+        }
+        set_pixel(o);
+      }
+      o.x++;
+    }
+  }
   void PicoGraphics::frame_convert(PenType type, conversion_callback_func callback) {};
+  bool PicoGraphics::get_data(PenType type, uint y, void *row_buf) {return false;}
   void PicoGraphics::sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent) {};
+  bool PicoGraphics::copy_pixel_span(const Point &src, const Point &dest, uint l) {return false;}
 
   int PicoGraphics::get_palette_size() {return 0;}
   RGB* PicoGraphics::get_palette() {return nullptr;}
@@ -28,11 +75,19 @@ namespace pimoroni {
   void PicoGraphics::set_font(const bitmap::font_t *font){
     this->bitmap_font = font;
     this->hershey_font = nullptr;
+    this->aa_font = nullptr;
   }
 
   void PicoGraphics::set_font(const hershey::font_t *font){
     this->bitmap_font = nullptr;
     this->hershey_font = font;
+    this->aa_font = nullptr;
+  }
+
+  void PicoGraphics::set_font(const aa::font_t *font){
+    this->bitmap_font = nullptr;
+    this->hershey_font = nullptr;
+    this->aa_font = font;
   }
 
   void PicoGraphics::set_font(std::string name){
@@ -81,6 +136,38 @@ namespace pimoroni {
     set_pixel_span(dest, l);
   }
 
+  void PicoGraphics::pixel_span_alpha(const Point &p, int32_t l, uint8_t a) {
+    if(a == 0) return;
+
+    // check if span in bounds
+    if( p.x + l <= clip.x || p.x >= clip.x + clip.w ||
+        p.y     <  clip.y || p.y >= clip.y + clip.h) return;
+
+    // clamp span horizontally
+    Point clipped = p;
+    if(clipped.x     <  clip.x)           {l += clipped.x - clip.x; clipped.x = clip.x;}
+    if(clipped.x + l >= clip.x + clip.w)  {l  = clip.x + clip.w - clipped.x;}
+
+    if(a == 255) {
+      set_pixel_span(clipped, l);
+    } else {
+      set_pixel_span_alpha(clipped, l, a);
+    }
+  }
+
+  void PicoGraphics::pixel_span_coverage(const Point &p, int32_t l, const uint8_t *coverage) {
+    // check if span in bounds
+    if( p.x + l <= clip.x || p.x >= clip.x + clip.w ||
+        p.y     <  clip.y || p.y >= clip.y + clip.h) return;
+
+    // clamp span horizontally, skipping the coverage of anything clipped on the left
+    Point clipped = p;
+    if(clipped.x     <  clip.x)           {l += clipped.x - clip.x; coverage += clip.x - clipped.x; clipped.x = clip.x;}
+    if(clipped.x + l >= clip.x + clip.w)  {l  = clip.x + clip.w - clipped.x;}
+
+    set_pixel_span_coverage(clipped, l, coverage);
+  }
+
   void PicoGraphics::rectangle(const Rect &r) {
     // clip and/or discard depending on rectangle visibility
     Rect clipped = r.intersection(clip);
@@ -125,6 +212,13 @@ namespace pimoroni {
   }
 
   void PicoGraphics::character(const char c, const Point &p, float s, float a) {
+    if (aa_font) {
+      aa::glyph(aa_font, [this](int32_t x, int32_t y, int32_t w, const uint8_t *coverage) {
+        pixel_span_coverage(Point(x, y), w, coverage);
+      }, (uint8_t)c, p.x, p.y);
+      return;
+    }
+
     if (bitmap_font) {
       bitmap::character(bitmap_font, [this](int32_t x, int32_t y, int32_t w, int32_t h) {
         rectangle(Rect(x, y, w, h));
@@ -133,14 +227,21 @@ namespace pimoroni {
     }
 
     if (hershey_font) {
-      hershey::glyph(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
-        line(Point(x1, y1), Point(x2, y2));
-      }, c, p.x, p.y, s, a);
+      hershey::glyph_strokes(hershey_font, [this](const int32_t *points, uint32_t count) {
+        stroke(points, count, 1);
+      }, c, p.x, p.y, hershey::transform(s, a));
       return;
     }
   }
 
   void PicoGraphics::text(const std::string &t, const Point &p, int32_t wrap, float s, float a, uint8_t letter_spacing) {
+    if (aa_font) {
+      aa::text(aa_font, [this](int32_t x, int32_t y, int32_t w, const uint8_t *coverage) {
+        pixel_span_coverage(Point(x, y), w, coverage);
+      }, t, p.x, p.y, wrap);
+      return;
+    }
+
     if (bitmap_font) {
       bitmap::text(bitmap_font, [this](int32_t x, int32_t y, int32_t w, int32_t h) {
         rectangle(Rect(x, y, w, h));
@@ -149,20 +250,38 @@ namespace pimoroni {
     }
 
     if (hershey_font) {
+      hershey::text_strokes(hershey_font, [this](const int32_t *points, uint32_t count) {
+        stroke(points, count, thickness);
+      }, t, p.x, p.y, s, a);
+      return;
+    }
+  }
+
+  void PicoGraphics::stroke(const int32_t *points, uint32_t count, uint thickness) {
+    // skip any stroke that falls entirely outside of the clip rectangle
+    Point tl(points[0], points[1]), br(points[0], points[1]);
+    for(auto i = 1u; i < count; i++) {
+      tl.x = std::min(tl.x, points[i * 2]); tl.y = std::min(tl.y, points[i * 2 + 1]);
+      br.x = std::max(br.x, points[i * 2]); br.y = std::max(br.y, points[i * 2 + 1]);
+    }
+    Rect stroke_bounds(tl, br);
+    stroke_bounds.inflate(thickness);
+    if(!stroke_bounds.intersects(clip)) return;
+
+    for(auto i = 1u; i < count; i++) {
+      Point p1(points[0], points[1]);
+      Point p2(points[2], points[3]);
       if(thickness == 1) {
-        hershey::text(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
-          line(Point(x1, y1), Point(x2, y2));
-        }, t, p.x, p.y, s, a);
+        line(p1, p2);
       } else {
-        hershey::text(hershey_font, [this](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
-          thick_line(Point(x1, y1), Point(x2, y2), thickness);
-        }, t, p.x, p.y, s, a);
+        thick_line(p1, p2, thickness);
       }
-      return;
+      points += 2;
     }
   }
 
   int32_t PicoGraphics::measure_text(const std::string &t, float s, uint8_t letter_spacing) {
+    if (aa_font) return aa::measure_text(aa_font, t);
     if (bitmap_font) return bitmap::measure_text(bitmap_font, t, std::max(1.0f, s), letter_spacing);
     if (hershey_font) return hershey::measure_text(hershey_font, t, s);
     return 0;
@@ -376,6 +495,83 @@ namespace pimoroni {
     }
   }
 
+  bool PicoGraphics::scroll(const Rect &r, int32_t dx, int32_t dy, exposed_func exposed) {
+    Rect region = r.intersection(clip);
+
+    if(region.empty()) return true;
+
+    // if the shift is larger than the region then nothing survives
+    if(std::abs(dx) >= region.w || std::abs(dy) >= region.h) {
+      if(exposed) exposed(region);
+      return true;
+    }
+
+    int32_t w = region.w - std::abs(dx);
+    int32_t h = region.h - std::abs(dy);
+    int32_t sx = dx < 0 ? region.x - dx : region.x;
+    int32_t sy = dy < 0 ? region.y - dy : region.y;
+
+    // when moving down walk the rows bottom up so we never copy
+    // from a row that has already been overwritten
+    for(int32_t i = 0; i < h; i++) {
+      int32_t row = dy > 0 ? h - 1 - i : i;
+      // pens that can't copy fail on the first row, before anything moves
+      if(!copy_pixel_span(Point(sx, sy + row), Point(sx + dx, sy + dy + row), w)) return false;
+    }
+
+    if(exposed) {
+      if(dy > 0) exposed(Rect(region.x, region.y, region.w, dy));
+      if(dy < 0) exposed(Rect(region.x, region.y + region.h + dy, region.w, -dy));
+
+      // columns, excluding any rows already reported above
+      int32_t ey = region.y + std::max(dy, int32_t(0));
+      if(dx > 0) exposed(Rect(region.x, ey, dx, h));
+      if(dx < 0) exposed(Rect(region.x + region.w + dx, ey, -dx, h));
+    }
+
+    return true;
+  }
+
+  // Copy n bits within a packed, MSB first, buffer. Bits are addressed from
+  // the start of the buffer and the source and destination may overlap.
+  void PicoGraphics::copy_bits(uint8_t *buf, uint32_t src, uint32_t dest, uint32_t n) {
+    if(n == 0 || src == dest) return;
+
+    auto copy_bit = [buf](uint32_t s, uint32_t d) {
+      uint8_t m = 0b10000000 >> (d & 0b111);
+      if(buf[s >> 3] & (0b10000000 >> (s & 0b111))) {
+        buf[d >> 3] |= m;
+      } else {
+        buf[d >> 3] &= ~m;
+      }
+    };
+
+    // split into leading bits up to a destination byte boundary,
+    // whole destination bytes and any trailing bits
+    uint32_t head = std::min(n, (8 - (dest & 0b111)) & 0b111);
+    uint32_t bytes = (n - head) / 8;
+    uint32_t tail = n - head - bytes * 8;
+
+    uint8_t *d = &buf[(dest + head) >> 3];
+    uint32_t s = src + head;
+    uint8_t shift = s & 0b111;
+
+    auto copy_byte = [buf, shift](uint32_t s) -> uint8_t {
+      const uint8_t *p = &buf[s >> 3];
+      return shift ? (p[0] << shift) | (p[1] >> (8 - shift)) : p[0];
+    };
+
+    if(dest < src) {
+      for(uint32_t i = 0; i < head; i++) copy_bit(src + i, dest + i);
+      for(uint32_t i = 0; i < bytes; i++) d[i] = copy_byte(s + i * 8);
+      for(uint32_t i = n - tail; i < n; i++) copy_bit(src + i, dest + i);
+    } else {
+      for(uint32_t i = n; i > n - tail; i--) copy_bit(src + i - 1, dest + i - 1);
+      for(uint32_t i = bytes; i > 0; i--) d[i - 1] = copy_byte(s + (i - 1) * 8);
+      for(uint32_t i = head; i > 0; i--) copy_bit(src + i - 1, dest + i - 1);
+    }
+  }
+
   // Common function for frame buffer conversion to 565 pixel format
   void PicoGraphics::frame_convert_rgb565(conversion_callback_func callback, next_pixel_func get_next_pixel)
   {
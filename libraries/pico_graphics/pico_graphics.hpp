@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <math.h>
 
 #include "libraries/hershey_fonts/hershey_fonts.hpp"
@@ -13,6 +14,7 @@
 #include "libraries/bitmap_fonts/font6_data.hpp"
 #include "libraries/bitmap_fonts/font8_data.hpp"
 #include "libraries/bitmap_fonts/font14_outline_data.hpp"
+#include "libraries/aa_fonts/aa_fonts.hpp"
 
 #include "common/pimoroni_common.hpp"
 
@@ -159,6 +161,42 @@ namespace pimoroni {
     void deflate(int32_t v);
   };
 
+  // A string shaped once into positioned glyphs and lines so it can be drawn,
+  // measured and hit-tested repeatedly without walking the text again
+  struct TextLayout {
+    enum Alignment {
+      ALIGN_LEFT,
+      ALIGN_CENTER,
+      ALIGN_RIGHT
+    };
+
+    struct Glyph {
+      char c;
+      unicode_sorta::codepage_t codepage;
+      int32_t x;        // offset from the start of the line
+      int32_t width;
+      uint32_t index;   // byte offset of the character in the source string
+    };
+
+    struct Line {
+      uint32_t first;   // index of the first glyph on this line
+      uint32_t count;
+      int32_t x, y;     // offset from the layout origin, including alignment
+      int32_t width;
+    };
+
+    const bitmap::font_t *bitmap_font = nullptr;
+    const hershey::font_t *hershey_font = nullptr;
+    float scale = 2.0f;
+    int32_t line_height = 0;
+    Rect bounds;
+
+    std::vector<Glyph> glyphs;
+    std::vector<Line> lines;
+
+    int hit_test(const Point &p) const;
+  };
+
   static const RGB565 rgb332_to_rgb565_lut[256] = {
     0x0000, 0x0800, 0x1000, 0x1800, 0x0001, 0x0801, 0x1001, 0x1801, 0x0002, 0x0802, 0x1002, 0x1802, 0x0003, 0x0803, 0x1003, 0x1803,
     0x0004, 0x0804, 0x1004, 0x1804, 0x0005, 0x0805, 0x1005, 0x1805, 0x0006, 0x0806, 0x1006, 0x1806, 0x0007, 0x0807, 0x1007, 0x1807,
@@ -191,7 +229,8 @@ namespace pimoroni {
       PEN_RGB332,
       PEN_RGB565,
       PEN_RGB888,
-      PEN_INKY7
+      PEN_INKY7,
+      PEN_COMPOSITOR
     };
 
     void *frame_buffer;
@@ -204,12 +243,14 @@ namespace pimoroni {
     typedef std::function<void(void *data, size_t length)> conversion_callback_func;
     typedef std::function<RGB565()> next_pixel_func;
     typedef std::function<RGB888()> next_pixel_func_rgb888;
+    typedef std::function<void(const Rect &exposed)> exposed_func;
     //typedef std::function<void(int y)> scanline_interrupt_func;
 
     //scanline_interrupt_func scanline_interrupt = nullptr;
 
     const bitmap::font_t *bitmap_font;
     const hershey::font_t *hershey_font;
+    const aa::font_t *aa_font = nullptr;
 
     static constexpr RGB332 rgb_to_rgb332(uint8_t r, uint8_t g, uint8_t b) {
       return RGB(r, g, b).to_rgb332();
@@ -263,18 +304,28 @@ namespace pimoroni {
     virtual void set_pixel_dither(const Point &p, const RGB &c);
     virtual void set_pixel_dither(const Point &p, const RGB565 &c);
     virtual void set_pixel_dither(const Point &p, const uint8_t &c);
+    virtual void set_pixel_span_alpha(const Point &p, uint l, uint8_t a);
+    // blend a span with its own alpha for each pixel, as anti-aliased text does
+    virtual void set_pixel_span_coverage(const Point &p, uint l, const uint8_t *coverage);
+    virtual void set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither);
     virtual void frame_convert(PenType type, conversion_callback_func callback);
     virtual void sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent);
+    // false if this pen can't move pixels within its frame buffer
+    virtual bool copy_pixel_span(const Point &src, const Point &dest, uint l);
 
     void set_font(const bitmap::font_t *font);
     void set_font(const hershey::font_t *font);
+    void set_font(const aa::font_t *font);
     void set_font(std::string font);
 
     void set_dimensions(int width, int height);
     void set_framebuffer(void *frame_buffer);
 
     void *get_data();
-    void get_data(PenType type, uint y, void *row_buf);
+    // read row y of the frame buffer into row_buf as PEN_RGB888 (one
+    // 32-bit word per pixel) or PEN_RGB565 (byte-swapped), false if this
+    // pen can't be read back
+    virtual bool get_data(PenType type, uint y, void *row_buf);
 
     void set_clip(const Rect &r);
     void remove_clip();
@@ -282,17 +333,26 @@ namespace pimoroni {
     void clear();
     void pixel(const Point &p);
     void pixel_span(const Point &p, int32_t l);
+    void pixel_span_alpha(const Point &p, int32_t l, uint8_t a);
+    void pixel_span_coverage(const Point &p, int32_t l, const uint8_t *coverage);
     void rectangle(const Rect &r);
     void circle(const Point &p, int32_t r);
     void character(const char c, const Point &p, float s = 2.0f, float a = 0.0f);
     void text(const std::string &t, const Point &p, int32_t wrap, float s = 2.0f, float a = 0.0f, uint8_t letter_spacing = 1);
     int32_t measure_text(const std::string &t, float s = 2.0f, uint8_t letter_spacing = 1);
+    // wraps as text() does with a bitmap font, anti-aliased fonts give an empty layout
+    TextLayout layout_text(const std::string &t, int32_t wrap, float s = 2.0f, uint8_t letter_spacing = 1, TextLayout::Alignment align = TextLayout::ALIGN_LEFT);
+    void text(const TextLayout &layout, const Point &p, float a = 0.0f);
     void polygon(const std::vector<Point> &points);
     void triangle(Point p1, Point p2, Point p3);
     void line(Point p1, Point p2);
     void thick_line(Point p1, Point p2, uint thickness);
+    // false, leaving the region untouched, if the pen can't copy pixels
+    bool scroll(const Rect &r, int32_t dx, int32_t dy, exposed_func exposed = nullptr);
 
   protected:
+    static void copy_bits(uint8_t *buf, uint32_t src, uint32_t dest, uint32_t n);
+    void stroke(const int32_t *points, uint32_t count, uint thickness);
     void frame_convert_rgb565(conversion_callback_func callback, next_pixel_func get_next_pixel);
     void frame_convert_rgb888(conversion_callback_func callback, next_pixel_func_rgb888 get_next_pixel);
   };
@@ -308,6 +368,8 @@ namespace pimoroni {
 
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
 
       static size_t buffer_size(uint w, uint h) {
           return w * h / 8;
@@ -325,6 +387,7 @@ namespace pimoroni {
 
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
 
       static size_t buffer_size(uint w, uint h) {
           return w * h / 8;
@@ -374,6 +437,7 @@ namespace pimoroni {
       void _set_pixel(const Point &p, uint col);
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
       void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
       void set_pixel_dither(const Point &p, const RGB &c) override;
 
@@ -408,10 +472,14 @@ namespace pimoroni {
 
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
       void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
+      void build_dither_cache();
       void set_pixel_dither(const Point &p, const RGB &c) override;
+      void set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) override;
 
       void frame_convert(PenType type, conversion_callback_func callback) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
       static size_t buffer_size(uint w, uint h) {
           return w * h / 2;
       }
@@ -442,10 +510,14 @@ namespace pimoroni {
 
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
       void get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates);
+      void build_dither_cache();
       void set_pixel_dither(const Point &p, const RGB &c) override;
+      void set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) override;
 
       void frame_convert(PenType type, conversion_callback_func callback) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h;
       }
@@ -462,12 +534,15 @@ namespace pimoroni {
       int create_pen_hsv(float h, float s, float v) override;
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
       void set_pixel_dither(const Point &p, const RGB &c) override;
       void set_pixel_dither(const Point &p, const RGB565 &c) override;
+      void set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) override;
 
       void sprite(void* data, const Point &sprite, const Point &dest, const int scale, const int transparent) override;
 
       void frame_convert(PenType type, conversion_callback_func callback) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h;
       }
@@ -485,6 +560,11 @@ namespace pimoroni {
       int create_pen_hsv(float h, float s, float v) override;
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      void set_pixel_span_alpha(const Point &p, uint l, uint8_t a) override;
+      void set_pixel_span_coverage(const Point &p, uint l, const uint8_t *coverage) override;
+      void set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h * sizeof(RGB565);
       }
@@ -502,6 +582,11 @@ namespace pimoroni {
       int create_pen_hsv(float h, float s, float v) override;
       void set_pixel(const Point &p) override;
       void set_pixel_span(const Point &p, uint l) override;
+      void set_pixel_span_alpha(const Point &p, uint l, uint8_t a) override;
+      void set_pixel_span_coverage(const Point &p, uint l, const uint8_t *coverage) override;
+      void set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) override;
+      bool copy_pixel_span(const Point &src, const Point &dest, uint l) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
       static size_t buffer_size(uint w, uint h) {
         return w * h * sizeof(uint32_t);
       }
@@ -587,4 +672,44 @@ namespace pimoroni {
         return w * h;
       }
   };
+
+  class PicoGraphics_Compositor : public PicoGraphics {
+    public:
+      struct Layer {
+        PicoGraphics *graphics;
+        Point offset;
+        int transparent = -1;   // raw pen value treated as see-through, -1 for none
+        uint8_t alpha = 255;    // layer opacity, 255 is fully opaque
+        bool visible = true;
+      };
+
+      std::vector<Layer> layers;
+      RGB888 background = 0;
+
+      // one composited RGB888 row plus a pair of output rows for
+      // frame_convert(), so a DMA transfer can run while the next is made
+      std::unique_ptr<RGB888[]> row_buffers;
+
+      PicoGraphics_Compositor(uint16_t width, uint16_t height);
+
+      // The compositor has no buffer of its own, draw into the layer surfaces instead
+      void set_pen(uint c) override {};
+      void set_pen(uint8_t r, uint8_t g, uint8_t b) override {};
+      void set_thickness(uint t) override {};
+      void set_pixel(const Point &p) override {};
+      void set_pixel_span(const Point &p, uint l) override {};
+
+      int add_layer(PicoGraphics *graphics, const Point &offset = Point(0, 0), int transparent = -1, uint8_t alpha = 255);
+      Layer &layer(uint i) {return layers[i];};
+      void set_layer_offset(uint i, const Point &offset);
+
+      // false if a layer has a pen type that can't be composited
+      bool composite_row(int32_t y, RGB888 *row);
+      // output is RGB565 or RGB888 only
+      void frame_convert(PenType type, conversion_callback_func callback) override;
+      bool get_data(PenType type, uint y, void *row_buf) override;
+      static size_t buffer_size(uint w, uint h) {
+        return 0;
+      }
+  };
 }
@@ -0,0 +1,199 @@
+#include <assert.h>
+
+#include "pico_graphics.hpp"
+
+namespace pimoroni {
+
+  // Mix two RGB888 colours, a = 0 gives dst and a = 255 gives src
+  static inline RGB888 blend_rgb888(RGB888 src, RGB888 dst, uint8_t a) {
+    uint32_t sa = a + 1;
+    uint32_t da = 256 - sa;
+    uint32_t rb = (((src & 0xff00ff) * sa + (dst & 0xff00ff) * da) >> 8) & 0xff00ff;
+    uint32_t g  = (((src & 0x00ff00) * sa + (dst & 0x00ff00) * da) >> 8) & 0x00ff00;
+    return rb | g;
+  }
+
+  static inline RGB565 rgb888_to_rgb565(RGB888 c) {
+    uint16_t p = ((c >> 8) & 0b1111100000000000) |
+                 ((c >> 5) & 0b0000011111100000) |
+                 ((c >> 3) & 0b0000000000011111);
+    return __builtin_bswap16(p);
+  }
+
+  // Walk a span of source pixels, fetch() returns the next raw pen value which is
+  // checked against the colour key before convert() turns it into RGB888
+  template<typename F, typename C>
+  static void composite_span(RGB888 *dst, int32_t l, int transparent, uint8_t alpha, F fetch, C convert) {
+    while(l--) {
+      uint32_t v = fetch();
+      if((int)v != transparent) {
+        if(alpha == 255) {
+          *dst = convert(v);
+        } else {
+          *dst = blend_rgb888(convert(v), *dst, alpha);
+        }
+      }
+      dst++;
+    }
+  }
+
+  PicoGraphics_Compositor::PicoGraphics_Compositor(uint16_t width, uint16_t height)
+  : PicoGraphics(width, height, nullptr) {
+    this->pen_type = PEN_COMPOSITOR;
+    row_buffers.reset(new RGB888[width * 2]);
+  }
+
+  int PicoGraphics_Compositor::add_layer(PicoGraphics *graphics, const Point &offset, int transparent, uint8_t alpha) {
+    switch(graphics->pen_type) {
+      case PEN_P4:
+      case PEN_P8:
+      case PEN_RGB332:
+      case PEN_RGB565:
+      case PEN_RGB888:
+        break;
+      default:
+        return -1; // Unsupported layer buffer
+    }
+    layers.push_back({graphics, offset, transparent, alpha, true});
+    return layers.size() - 1;
+  }
+
+  void PicoGraphics_Compositor::set_layer_offset(uint i, const Point &offset) {
+    if(i < layers.size()) layers[i].offset = offset;
+  }
+
+  bool PicoGraphics_Compositor::composite_row(int32_t y, RGB888 *row) {
+    for(auto x = 0; x < bounds.w; x++) {
+      row[x] = background;
+    }
+
+    // Layers are stacked bottom to top in the order they were added
+    for(auto &layer : layers) {
+      if(!layer.visible || layer.alpha == 0) continue;
+
+      PicoGraphics *g = layer.graphics;
+      int32_t ly = y - layer.offset.y;
+      if(ly < 0 || ly >= g->bounds.h) continue;
+
+      // clip the layer row against the output row
+      int32_t x1 = std::max(int32_t(0), layer.offset.x);
+      int32_t x2 = std::min(bounds.w, layer.offset.x + g->bounds.w);
+      if(x2 <= x1) continue;
+
+      int32_t lx = x1 - layer.offset.x;
+      int32_t l = x2 - x1;
+      int32_t i = lx + ly * g->bounds.w;
+      RGB888 *dst = row + x1;
+
+      switch(g->pen_type) {
+        case PEN_P4: {
+          const uint8_t *src = (const uint8_t *)g->frame_buffer;
+          const RGB *palette = g->get_palette();
+          composite_span(dst, l, layer.transparent, layer.alpha, [&]() {
+            uint8_t b = src[i >> 1];
+            uint32_t v = (i & 0b1) ? (b & 0xf) : (b >> 4);
+            i++;
+            return v;
+          }, [palette](uint32_t v) {
+            return RGB(palette[v]).to_rgb888();
+          });
+          break;
+        }
+        case PEN_P8: {
+          const uint8_t *src = (const uint8_t *)g->frame_buffer + i;
+          const RGB *palette = g->get_palette();
+          composite_span(dst, l, layer.transparent, layer.alpha, [&]() {
+            return uint32_t(*src++);
+          }, [palette](uint32_t v) {
+            return RGB(palette[v]).to_rgb888();
+          });
+          break;
+        }
+        case PEN_RGB332: {
+          const RGB332 *src = (const RGB332 *)g->frame_buffer + i;
+          composite_span(dst, l, layer.transparent, layer.alpha, [&]() {
+            return uint32_t(*src++);
+          }, [](uint32_t v) {
+            return RGB((RGB332)v).to_rgb888();
+          });
+          break;
+        }
+        case PEN_RGB565: {
+          const RGB565 *src = (const RGB565 *)g->frame_buffer + i;
+          composite_span(dst, l, layer.transparent, layer.alpha, [&]() {
+            return uint32_t(*src++);
+          }, [](uint32_t v) {
+            return RGB((RGB565)v).to_rgb888();
+          });
+          break;
+        }
+        case PEN_RGB888: {
+          const RGB888 *src = (const RGB888 *)g->frame_buffer + i;
+          composite_span(dst, l, layer.transparent, layer.alpha, [&]() {
+            return uint32_t(*src++ & 0xffffff);
+          }, [](uint32_t v) {
+            return RGB888(v);
+          });
+          break;
+        }
+        default:
+          // add_layer() refuses these, but layers can be added by hand
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void PicoGraphics_Compositor::frame_convert(PenType type, conversion_callback_func callback) {
+    // Rows are composited on the fly, so only a pair of row buffers are needed.
+    // Two are used as the callback may transfer by DMA while we prepare the next row.
+    // A row that can't be composited ends the frame early
+    assert(type == PEN_RGB565 || type == PEN_RGB888);
+
+    if(type == PEN_RGB565) {
+      // the RGB565 output rows share the second half of the buffers
+      RGB888 *row = row_buffers.get();
+      RGB565 *row_buf[2] = {(RGB565 *)(row + bounds.w), (RGB565 *)(row + bounds.w) + bounds.w};
+      int buf_idx = 0;
+
+      for(auto y = 0; y < bounds.h; y++) {
+        if(!composite_row(y, row)) break;
+        for(auto x = 0; x < bounds.w; x++) {
+          row_buf[buf_idx][x] = rgb888_to_rgb565(row[x]);
+        }
+        callback(row_buf[buf_idx], bounds.w * sizeof(RGB565));
+        buf_idx ^= 1;
+      }
+
+      // Callback with zero length to ensure previous buffer is fully written
+      callback(row_buf[buf_idx], 0);
+    } else if(type == PEN_RGB888) {
+      RGB888 *row_buf[2] = {row_buffers.get(), row_buffers.get() + bounds.w};
+      int buf_idx = 0;
+
+      for(auto y = 0; y < bounds.h; y++) {
+        if(!composite_row(y, row_buf[buf_idx])) break;
+        callback(row_buf[buf_idx], bounds.w * sizeof(RGB888));
+        buf_idx ^= 1;
+      }
+
+      callback(row_buf[buf_idx], 0);
+    }
+  }
+
+  bool PicoGraphics_Compositor::get_data(PenType type, uint y, void *row_buf) {
+    if(type == PEN_RGB888) {
+      return composite_row(y, (RGB888 *)row_buf);
+    } else if(type == PEN_RGB565) {
+      RGB888 *row = row_buffers.get();
+      if(!composite_row(y, row)) return false;
+      RGB565 *dest = (RGB565 *)row_buf;
+      for(auto x = 0; x < bounds.w; x++) {
+        dest[x] = rgb888_to_rgb565(row[x]);
+      }
+    } else {
+      return false;
+    }
+    return true;
+  }
+}
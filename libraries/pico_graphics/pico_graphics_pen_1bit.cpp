@@ -58,4 +58,27 @@ namespace pimoroni {
     }
   }
 
-}
\ No newline at end of file
+  bool PicoGraphics_Pen1Bit::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+    uint32_t s = ((src.x / 8) + (src.y * bounds.w / 8)) * 8 + (src.x & 0b111);
+    uint32_t d = ((dest.x / 8) + (dest.y * bounds.w / 8)) * 8 + (dest.x & 0b111);
+    copy_bits((uint8_t *)frame_buffer, s, d, l);
+    return true;
+  }
+
+  bool PicoGraphics_Pen1Bit::get_data(PenType type, uint y, void *row_buf) {
+    // set bits are white, eight pixels to a byte with the leftmost in bit 7
+    const uint8_t *src = (const uint8_t *)frame_buffer + y * bounds.w / 8;
+    for(auto x = 0; x < bounds.w; x++) {
+      bool on = src[x >> 3] & (0x80 >> (x & 0b111));
+      if(type == PEN_RGB565) {
+        ((RGB565 *)row_buf)[x] = on ? 0xffff : 0x0000;
+      } else if(type == PEN_RGB888) {
+        ((RGB888 *)row_buf)[x] = on ? 0xffffff : 0x000000;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}
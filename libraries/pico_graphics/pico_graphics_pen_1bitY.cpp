@@ -58,4 +58,27 @@ namespace pimoroni {
     }
   }
 
-}
\ No newline at end of file
+  bool PicoGraphics_Pen1BitY::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+    // columns are packed vertically so a horizontal span isn't contiguous,
+    // copy pixel by pixel in whichever direction avoids overwriting the source
+    uint8_t *buf = (uint8_t *)frame_buffer;
+    int32_t step = dest.x > src.x ? -1 : 1;
+    int32_t o = step < 0 ? l - 1 : 0;
+
+    while(l--) {
+      int32_t sx = src.x + o, dx = dest.x + o;
+      uint8_t sb = 0b10000000 >> (src.y & 0b111);
+      uint8_t db = 0b10000000 >> (dest.y & 0b111);
+      uint8_t *d = &buf[(dest.y / 8) + (dx * bounds.h / 8)];
+
+      if(buf[(src.y / 8) + (sx * bounds.h / 8)] & sb) {
+        *d |= db;
+      } else {
+        *d &= ~db;
+      }
+      o += step;
+    }
+    return true;
+  }
+
+}
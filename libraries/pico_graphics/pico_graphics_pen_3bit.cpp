@@ -133,4 +133,17 @@ namespace pimoroni {
             }
         }
     }
-}
\ No newline at end of file
+    bool PicoGraphics_Pen3Bit::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+        uint offset = (bounds.w * bounds.h) / 8;
+        uint8_t *buf = (uint8_t *)frame_buffer;
+
+        uint32_t s = ((src.x / 8) + (src.y * bounds.w / 8)) * 8 + (src.x & 0b111);
+        uint32_t d = ((dest.x / 8) + (dest.y * bounds.w / 8)) * 8 + (dest.x & 0b111);
+
+        // shift each of the three bit planes
+        copy_bits(buf, s, d, l);
+        copy_bits(buf + offset, s, d, l);
+        copy_bits(buf + offset + offset, s, d, l);
+        return true;
+    }
+}
@@ -89,6 +89,14 @@ namespace pimoroni {
         if(l) {*f &= 0b00001111; *f |= (cc & 0b11110000);}
     }
 
+    bool PicoGraphics_PenP4::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+        // pixels are packed as nibbles, high nibble first
+        uint32_t s = (src.x + src.y * bounds.w) * 4;
+        uint32_t d = (dest.x + dest.y * bounds.w) * 4;
+        copy_bits((uint8_t *)frame_buffer, s, d, l * 4);
+        return true;
+    }
+
     void PicoGraphics_PenP4::get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates) {
         RGB error;
         for(size_t i = 0; i < candidates.size(); i++) {
@@ -104,8 +112,8 @@ namespace pimoroni {
         });
     }
 
-    void PicoGraphics_PenP4::set_pixel_dither(const Point &p, const RGB &c) {
-        if(!bounds.contains(p)) return;
+    void PicoGraphics_PenP4::build_dither_cache() {
+        if(cache_built) return;
 
         uint used_palette_entries = 0;
         for(auto i = 0u; i < palette_size; i++) {
@@ -113,13 +121,17 @@ namespace pimoroni {
             used_palette_entries++;
         }
 
-        if(!cache_built) {
-            for(uint i = 0; i < 512; i++) {
-                RGB cache_col((i & 0x1C0) >> 1, (i & 0x38) << 2, (i & 0x7) << 5);
-                get_dither_candidates(cache_col, palette, used_palette_entries, candidate_cache[i]);
-            }
-            cache_built = true;
+        for(uint i = 0; i < 512; i++) {
+            RGB cache_col((i & 0x1C0) >> 1, (i & 0x38) << 2, (i & 0x7) << 5);
+            get_dither_candidates(cache_col, palette, used_palette_entries, candidate_cache[i]);
         }
+        cache_built = true;
+    }
+
+    void PicoGraphics_PenP4::set_pixel_dither(const Point &p, const RGB &c) {
+        if(!bounds.contains(p)) return;
+
+        build_dither_cache();
 
         uint cache_key = ((c.r & 0xE0) << 1) | ((c.g & 0xE0) >> 2) | ((c.b & 0xE0) >> 5);
         //get_dither_candidates(c, palette, 256, candidates);
@@ -132,6 +144,37 @@ namespace pimoroni {
         color = candidate_cache[cache_key][dither16_pattern[pattern_index]];
         set_pixel(p);
     }
+    void PicoGraphics_PenP4::set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) {
+        Point o = p;
+
+        if(!dither) {
+            // images tend to have runs of the same colour, so only search
+            // the palette again when it changes
+            RGB565 last = ~*data;
+            while(l--) {
+                if(*data != last) {
+                    last = *data;
+                    color = std::max(0, RGB(last).closest(palette, palette_size));
+                }
+                set_pixel(o);
+                data++;
+                o.x++;
+            }
+            return;
+        }
+
+        build_dither_cache();
+
+        const uint8_t *pattern = &dither16_pattern[(p.y & 0b11) << 2];
+        while(l--) {
+            RGB565 c = __builtin_bswap16(*data++);
+            // top three bits of each channel, as set_pixel_dither() uses
+            uint cache_key = ((c & 0xE000) >> 7) | ((c & 0x0700) >> 5) | ((c & 0x001C) >> 2);
+            color = candidate_cache[cache_key][pattern[o.x & 0b11]];
+            set_pixel(o);
+            o.x++;
+        }
+    }
     void PicoGraphics_PenP4::frame_convert(PenType type, conversion_callback_func callback) {
         if(type == PEN_RGB565) {
             // Cache the RGB888 palette as RGB565
@@ -156,4 +199,22 @@ namespace pimoroni {
             });
         }
     }
+    bool PicoGraphics_PenP4::get_data(PenType type, uint y, void *row_buf) {
+        // two pixels to a byte, the left one in the high nibble
+        const uint8_t *src = (const uint8_t *)frame_buffer + y * bounds.w / 2;
+        if(type == PEN_RGB565) {
+            RGB565 *dest = (RGB565 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = palette[(src[x >> 1] >> ((~x & 1) << 2)) & 0xf].to_rgb565();
+            }
+        } else if(type == PEN_RGB888) {
+            RGB888 *dest = (RGB888 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = palette[(src[x >> 1] >> ((~x & 1) << 2)) & 0xf].to_rgb888();
+            }
+        } else {
+            return false;
+        }
+        return true;
+    }
 }
@@ -1,4 +1,5 @@
 #include "pico_graphics.hpp"
+#include <string.h>
 
 namespace pimoroni {
     PicoGraphics_PenP8::PicoGraphics_PenP8(uint16_t width, uint16_t height, void *frame_buffer)
@@ -64,6 +65,12 @@ namespace pimoroni {
         }
     }
 
+    bool PicoGraphics_PenP8::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+        uint8_t *buf = (uint8_t *)frame_buffer;
+        memmove(&buf[dest.y * bounds.w + dest.x], &buf[src.y * bounds.w + src.x], l);
+        return true;
+    }
+
     void PicoGraphics_PenP8::get_dither_candidates(const RGB &col, const RGB *palette, size_t len, std::array<uint8_t, 16> &candidates) {
         RGB error;
         for(size_t i = 0; i < candidates.size(); i++) {
@@ -79,16 +86,20 @@ namespace pimoroni {
         });
     }
 
+    void PicoGraphics_PenP8::build_dither_cache() {
+        if(cache_built) return;
+
+        for(uint i = 0; i < 512; i++) {
+            RGB cache_col((i & 0x1C0) >> 1, (i & 0x38) << 2, (i & 0x7) << 5);
+            get_dither_candidates(cache_col, palette, palette_size, candidate_cache[i]);
+        }
+        cache_built = true;
+    }
+
     void PicoGraphics_PenP8::set_pixel_dither(const Point &p, const RGB &c) {
         if(!bounds.contains(p)) return;
 
-        if(!cache_built) {
-            for(uint i = 0; i < 512; i++) {
-                RGB cache_col((i & 0x1C0) >> 1, (i & 0x38) << 2, (i & 0x7) << 5);
-                get_dither_candidates(cache_col, palette, palette_size, candidate_cache[i]);
-            }
-            cache_built = true;
-        }
+        build_dither_cache();
 
         uint cache_key = ((c.r & 0xE0) << 1) | ((c.g & 0xE0) >> 2) | ((c.b & 0xE0) >> 5);
         //get_dither_candidates(c, palette, 256, candidates);
@@ -102,6 +113,37 @@ namespace pimoroni {
         set_pixel(p);
     }
 
+    void PicoGraphics_PenP8::set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) {
+        uint8_t *buf = (uint8_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        if(!dither) {
+            // images tend to have runs of the same colour, so only search
+            // the palette again when it changes
+            RGB565 last = ~*data;
+            uint8_t pen = 0;
+            while(l--) {
+                if(*data != last) {
+                    last = *data;
+                    pen = std::max(0, RGB(last).closest(palette, palette_size));
+                }
+                *buf++ = pen;
+                data++;
+            }
+            return;
+        }
+
+        build_dither_cache();
+
+        const uint8_t *pattern = &dither16_pattern[(p.y & 0b11) << 2];
+        for(auto x = p.x; l--; x++) {
+            RGB565 c = __builtin_bswap16(*data++);
+            // top three bits of each channel, as set_pixel_dither() uses
+            uint cache_key = ((c & 0xE000) >> 7) | ((c & 0x0700) >> 5) | ((c & 0x001C) >> 2);
+            *buf++ = candidate_cache[cache_key][pattern[x & 0b11]];
+        }
+    }
+
     void PicoGraphics_PenP8::frame_convert(PenType type, conversion_callback_func callback) {
         if(type == PEN_RGB565) {
             // Cache the RGB888 palette as RGB565
@@ -125,4 +167,21 @@ namespace pimoroni {
             });
         }
     }
+    bool PicoGraphics_PenP8::get_data(PenType type, uint y, void *row_buf) {
+        const uint8_t *src = (const uint8_t *)frame_buffer + y * bounds.w;
+        if(type == PEN_RGB565) {
+            RGB565 *dest = (RGB565 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = palette[src[x]].to_rgb565();
+            }
+        } else if(type == PEN_RGB888) {
+            RGB888 *dest = (RGB888 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = palette[src[x]].to_rgb888();
+            }
+        } else {
+            return false;
+        }
+        return true;
+    }
 }
@@ -34,6 +34,11 @@ namespace pimoroni {
             *buf++ = color;
         }
     }
+    bool PicoGraphics_PenRGB332::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+        uint8_t *buf = (uint8_t *)frame_buffer;
+        memmove(&buf[dest.y * bounds.w + dest.x], &buf[src.y * bounds.w + src.x], l);
+        return true;
+    }
     void PicoGraphics_PenRGB332::set_pixel_dither(const Point &p, const RGB &c) {
         if(!bounds.contains(p)) return;
         uint8_t _dmv = dither16_pattern[(p.x & 0b11) | ((p.y & 0b11) << 2)];
@@ -81,6 +86,33 @@ namespace pimoroni {
 
         set_pixel(p);
     }
+    void PicoGraphics_PenRGB332::set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) {
+        uint8_t *buf = (uint8_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        if(!dither) {
+            while(l--) {
+                *buf++ = rgb565_to_rgb332(*data++);
+            }
+            return;
+        }
+
+        // same as set_pixel_dither(RGB565) with the pattern row looked up once
+        const uint8_t *pattern = &dither16_pattern[(p.y & 0b11) << 2];
+        for(auto x = p.x; l--; x++) {
+            RGB565 cs = __builtin_bswap16(*data++);
+            uint8_t _dmv = pattern[x & 0b11];
+
+            uint8_t c = ((cs & 0b1100000000000000) >> 8) |
+                        ((cs & 0b0000011000000000) >> 6) |
+                        ((cs & 0b0000000000010000) >> 3);
+            if(((cs & 0b0011100000000000) >> 10) > _dmv) c |= 0b00100000;
+            if(((cs & 0b0000000111100000) >> 5) > _dmv) c |= 0b00000100;
+            if((cs & 0b0000000000001111) > _dmv) c |= 0b00000001;
+
+            *buf++ = c;
+        }
+    }
     void PicoGraphics_PenRGB332::frame_convert(PenType type, conversion_callback_func callback) {
         if(type == PEN_RGB565) {
 
@@ -113,4 +145,21 @@ namespace pimoroni {
             }
         }
     }
+    bool PicoGraphics_PenRGB332::get_data(PenType type, uint y, void *row_buf) {
+        const RGB332 *src = (const RGB332 *)frame_buffer + y * bounds.w;
+        if(type == PEN_RGB565) {
+            RGB565 *dest = (RGB565 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = rgb332_to_rgb565_lut[src[x]];
+            }
+        } else if(type == PEN_RGB888) {
+            RGB888 *dest = (RGB888 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = RGB(src[x]).to_rgb888();
+            }
+        } else {
+            return false;
+        }
+        return true;
+    }
 }
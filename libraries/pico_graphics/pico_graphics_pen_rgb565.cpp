@@ -1,4 +1,5 @@
 #include "pico_graphics.hpp"
+#include <string.h>
 
 namespace pimoroni {
     PicoGraphics_PenRGB565::PicoGraphics_PenRGB565(uint16_t width, uint16_t height, void *frame_buffer)
@@ -34,4 +35,65 @@ namespace pimoroni {
             *buf++ = color;
         }
     }
-}
\ No newline at end of file
+    bool PicoGraphics_PenRGB565::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+        uint16_t *buf = (uint16_t *)frame_buffer;
+        memmove(&buf[dest.y * bounds.w + dest.x], &buf[src.y * bounds.w + src.x], l * sizeof(uint16_t));
+        return true;
+    }
+    void PicoGraphics_PenRGB565::set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) {
+        uint16_t *buf = (uint16_t *)frame_buffer;
+        memcpy(&buf[p.y * bounds.w + p.x], data, l * sizeof(RGB565));
+    }
+    void PicoGraphics_PenRGB565::set_pixel_span_alpha(const Point &p, uint l, uint8_t a) {
+        uint16_t *buf = (uint16_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        // spread the 565 channels out into a 32-bit word with room between them
+        // so all three can be blended with a single multiply, using 5-bit alpha
+        uint32_t a5 = (a + 4) >> 3;
+        uint32_t c = __builtin_bswap16(color);
+        c = (c | (c << 16)) & 0b00000111111000001111100000011111;
+
+        while(l--) {
+            uint32_t d = __builtin_bswap16(*buf);
+            d = (d | (d << 16)) & 0b00000111111000001111100000011111;
+            d = (d + (((c - d) * a5) >> 5)) & 0b00000111111000001111100000011111;
+            *buf++ = __builtin_bswap16(uint16_t(d | (d >> 16)));
+        }
+    }
+    void PicoGraphics_PenRGB565::set_pixel_span_coverage(const Point &p, uint l, const uint8_t *coverage) {
+        uint16_t *buf = (uint16_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        // blended as set_pixel_span_alpha() does, with the alpha taken per pixel
+        uint32_t c = __builtin_bswap16(color);
+        c = (c | (c << 16)) & 0b00000111111000001111100000011111;
+
+        while(l--) {
+            uint32_t a5 = (*coverage++ + 4) >> 3;
+            if(a5 == 32) {
+                *buf = color;
+            } else if(a5) {
+                uint32_t d = __builtin_bswap16(*buf);
+                d = (d | (d << 16)) & 0b00000111111000001111100000011111;
+                d = (d + (((c - d) * a5) >> 5)) & 0b00000111111000001111100000011111;
+                *buf = __builtin_bswap16(uint16_t(d | (d >> 16)));
+            }
+            buf++;
+        }
+    }
+    bool PicoGraphics_PenRGB565::get_data(PenType type, uint y, void *row_buf) {
+        const RGB565 *src = (const RGB565 *)frame_buffer + y * bounds.w;
+        if(type == PEN_RGB565) {
+            memcpy(row_buf, src, bounds.w * sizeof(RGB565));
+        } else if(type == PEN_RGB888) {
+            RGB888 *dest = (RGB888 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = RGB(src[x]).to_rgb888();
+            }
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
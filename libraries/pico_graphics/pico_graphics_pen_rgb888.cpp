@@ -1,4 +1,5 @@
 #include "pico_graphics.hpp"
+#include <string.h>
 
 namespace pimoroni {
     PicoGraphics_PenRGB888::PicoGraphics_PenRGB888(uint16_t width, uint16_t height, void *frame_buffer)
@@ -34,4 +35,63 @@ namespace pimoroni {
             *buf++ = color;
         }
     }
-}
\ No newline at end of file
+    bool PicoGraphics_PenRGB888::copy_pixel_span(const Point &src, const Point &dest, uint l) {
+        uint32_t *buf = (uint32_t *)frame_buffer;
+        memmove(&buf[dest.y * bounds.w + dest.x], &buf[src.y * bounds.w + src.x], l * sizeof(uint32_t));
+        return true;
+    }
+    void PicoGraphics_PenRGB888::set_pixel_span_alpha(const Point &p, uint l, uint8_t a) {
+        uint32_t *buf = (uint32_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        uint32_t sa = a + 1;
+        uint32_t da = 256 - sa;
+        uint32_t src_rb = (color & 0xff00ff) * sa;
+        uint32_t src_g = (color & 0x00ff00) * sa;
+        while(l--) {
+            uint32_t d = *buf;
+            *buf++ = (((src_rb + (d & 0xff00ff) * da) >> 8) & 0xff00ff) |
+                     (((src_g  + (d & 0x00ff00) * da) >> 8) & 0x00ff00);
+        }
+    }
+    void PicoGraphics_PenRGB888::set_pixel_span_coverage(const Point &p, uint l, const uint8_t *coverage) {
+        uint32_t *buf = (uint32_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        while(l--) {
+            uint8_t a = *coverage++;
+            if(a == 255) {
+                *buf = color;
+            } else if(a) {
+                uint32_t sa = a + 1;
+                uint32_t da = 256 - sa;
+                uint32_t d = *buf;
+                *buf = ((((color & 0xff00ff) * sa + (d & 0xff00ff) * da) >> 8) & 0xff00ff) |
+                       ((((color & 0x00ff00) * sa + (d & 0x00ff00) * da) >> 8) & 0x00ff00);
+            }
+            buf++;
+        }
+    }
+    void PicoGraphics_PenRGB888::set_pixel_span_rgb565(const Point &p, uint l, const RGB565 *data, bool dither) {
+        uint32_t *buf = (uint32_t *)frame_buffer;
+        buf = &buf[p.y * bounds.w + p.x];
+
+        while(l--) {
+            *buf++ = RGB(*data++).to_rgb888();
+        }
+    }
+    bool PicoGraphics_PenRGB888::get_data(PenType type, uint y, void *row_buf) {
+        const RGB888 *src = (const RGB888 *)frame_buffer + y * bounds.w;
+        if(type == PEN_RGB888) {
+            memcpy(row_buf, src, bounds.w * sizeof(RGB888));
+        } else if(type == PEN_RGB565) {
+            RGB565 *dest = (RGB565 *)row_buf;
+            for(auto x = 0; x < bounds.w; x++) {
+                dest[x] = RGB(uint(src[x])).to_rgb565();
+            }
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
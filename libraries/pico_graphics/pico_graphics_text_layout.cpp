@@ -0,0 +1,185 @@
+#include "pico_graphics.hpp"
+
+namespace pimoroni {
+
+  int TextLayout::hit_test(const Point &p) const {
+    for(auto &line : lines) {
+      if(p.y < line.y || p.y >= line.y + line_height) continue;
+
+      for(auto i = line.first; i < line.first + line.count; i++) {
+        int32_t x = line.x + glyphs[i].x;
+        if(p.x >= x && p.x < x + glyphs[i].width) return i;
+      }
+      return -1;
+    }
+    return -1;
+  }
+
+  TextLayout PicoGraphics::layout_text(const std::string &t, int32_t wrap, float s, uint8_t letter_spacing, TextLayout::Alignment align) {
+    TextLayout layout;
+    layout.bitmap_font = bitmap_font;
+    layout.hershey_font = hershey_font;
+    layout.scale = s;
+
+    int32_t space_width = 0;
+    int32_t spacing = 0;
+    uint8_t scale = std::max(1.0f, s);
+
+    if(bitmap_font) {
+      layout.line_height = (bitmap_font->height + 1) * scale;
+      space_width = bitmap_font->widths[0] * scale;
+      spacing = letter_spacing * scale;
+    } else if(hershey_font) {
+      layout.line_height = hershey::line_height * s;
+      space_width = hershey::measure_glyph(hershey_font, ' ', s);
+    } else {
+      return layout;
+    }
+
+    auto &glyphs = layout.glyphs;
+    auto &lines = layout.lines;
+
+    uint32_t line_start = 0;  // first glyph of the current line
+    uint32_t co = 0;          // pen position on the current line
+    unicode_sorta::codepage_t codepage = unicode_sorta::PAGE_195;
+
+    auto end_line = [&](uint32_t end) {
+      int32_t width = end > line_start ? glyphs[end - 1].x + glyphs[end - 1].width : 0;
+      lines.push_back({line_start, end - line_start, 0, int32_t(lines.size()) * layout.line_height, width});
+      line_start = end;
+    };
+
+    auto measure = [&](char c) -> int32_t {
+      return bitmap_font
+        ? bitmap::measure_character(bitmap_font, c, scale, codepage)
+        : hershey::measure_glyph(hershey_font, c, s);
+    };
+
+    // Words are split and wrapped exactly as bitmap::text() does it, so that
+    // a layout draws the same pixels as text(). That includes its quirks: a
+    // word runs up to the next space or newline after its first character, so
+    // a leading space or newline belongs to the word, and a newline is only
+    // honoured at the start of a word, otherwise it separates words like a space
+    size_t i = 0;
+    while(i < t.length()) {
+      size_t next_space = t.find(' ', i + 1);
+      if(next_space == std::string::npos) {
+        next_space = t.length();
+      }
+
+      size_t next_linebreak = t.find('\n', i + 1);
+      if(next_linebreak == std::string::npos) {
+        next_linebreak = t.length();
+      }
+
+      size_t next_break = std::min(next_space, next_linebreak);
+
+      // truncated to 16 bits as bitmap::text() does
+      uint16_t word_width = 0;
+      for(size_t j = i; j < next_break; j++) {
+        if(t[j] == unicode_sorta::PAGE_194_START) {
+          codepage = unicode_sorta::PAGE_194;
+          continue;
+        } else if(t[j] == unicode_sorta::PAGE_195_START) {
+          continue;
+        }
+        word_width += measure(t[j]);
+        codepage = unicode_sorta::PAGE_195;
+      }
+
+      // if this word would exceed the wrap limit then move to the next line,
+      // a wrap of 0 breaks before every word and a negative wrap never does
+      if(co != 0 && co + word_width > (uint32_t)wrap) {
+        end_line(glyphs.size());
+        co = 0;
+      }
+
+      for(size_t j = i; j < next_break; j++) {
+        char c = t[j];
+        if(c == unicode_sorta::PAGE_194_START) {
+          codepage = unicode_sorta::PAGE_194;
+          continue;
+        } else if(c == unicode_sorta::PAGE_195_START) {
+          continue;
+        }
+        if(c == '\n') {
+          end_line(glyphs.size());
+          co = 0;
+        } else {
+          int32_t width = measure(c);
+          glyphs.push_back({c, codepage, int32_t(co), width, uint32_t(j)});
+          co += width + spacing;
+        }
+        codepage = unicode_sorta::PAGE_195;
+      }
+
+      // move to the end of the word and add a space
+      co += space_width;
+      i = next_break + 1;
+    }
+
+    end_line(glyphs.size());
+
+    // align each line within the wrap width, or the widest line if not wrapping
+    int32_t max_width = 0;
+    for(auto &line : lines) {
+      max_width = std::max(max_width, line.width);
+    }
+
+    int32_t container_width = wrap > 0 ? wrap : max_width;
+    int32_t min_x = container_width;
+    for(auto &line : lines) {
+      if(align == TextLayout::ALIGN_CENTER) {
+        line.x = (container_width - line.width) / 2;
+      } else if(align == TextLayout::ALIGN_RIGHT) {
+        line.x = container_width - line.width;
+      }
+      min_x = std::min(min_x, line.x);
+    }
+
+    layout.bounds = Rect(min_x, 0, max_width, lines.size() * layout.line_height);
+
+    return layout;
+  }
+
+  void PicoGraphics::text(const TextLayout &layout, const Point &p, float a) {
+    if(layout.bitmap_font) {
+      uint8_t scale = std::max(1.0f, layout.scale);
+      bitmap::rect_func rect = [this](int32_t x, int32_t y, int32_t w, int32_t h) {
+        rectangle(Rect(x, y, w, h));
+      };
+
+      for(auto &line : layout.lines) {
+        // skip lines outside of the clip rectangle entirely, allowing
+        // for accents which can extend 8 pixels above the line
+        Rect line_bounds(p.x + line.x, p.y + line.y - 8 * scale, line.width, layout.line_height + 8 * scale);
+        if(!line_bounds.intersects(clip)) continue;
+
+        for(auto i = line.first; i < line.first + line.count; i++) {
+          auto &g = layout.glyphs[i];
+          bitmap::character(layout.bitmap_font, rect, g.c, p.x + line.x + g.x, p.y + line.y, scale, g.codepage);
+        }
+      }
+      return;
+    }
+
+    if(layout.hershey_font) {
+      // glyphs are placed along the rotated baseline of each line
+      hershey::transform_t t = hershey::transform(layout.scale, a);
+      hershey::stroke_func draw_stroke = [this](const int32_t *points, uint32_t count) {
+        stroke(points, count, thickness);
+      };
+
+      for(auto &line : layout.lines) {
+        for(auto i = line.first; i < line.first + line.count; i++) {
+          auto &g = layout.glyphs[i];
+          int32_t ox = line.x + g.x;
+          int32_t oy = line.y;
+          int32_t rx = ((int64_t)ox * t.cos_a - (int64_t)oy * t.sin_a + 0x8000) >> 16;
+          int32_t ry = ((int64_t)ox * t.sin_a + (int64_t)oy * t.cos_a + 0x8000) >> 16;
+          hershey::glyph_strokes(layout.hershey_font, draw_stroke, g.c, p.x + rx, p.y + ry, t);
+        }
+      }
+    }
+  }
+}
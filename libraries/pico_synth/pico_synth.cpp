@@ -204,4 +204,263 @@ namespace pimoroni {
     return sample;
   }
 
+  // a * b >> 16, as a 64 bit multiply would give it, for b of at most 16
+  // bits and |a| under 2^23. Two 32 bit multiplies that can't overflow are
+  // far cheaper than a 64 bit one on a Cortex-M0+
+  static inline int32_t mul_q16(int32_t a, uint32_t b) {
+    return (a * int32_t(b >> 8) + ((a * int32_t(b & 0xff)) >> 8)) >> 8;
+  }
+
+  // how many of the next count frames a channel plays before it switches off
+  static uint32_t active_frames(const AudioChannel &channel, uint32_t count) {
+    if(channel.adsr_phase == ADSRPhase::OFF) {
+      return 0;
+    }
+    if(channel.adsr_phase == ADSRPhase::RELEASE) {
+      // it switches off on the frame the release ends, but still plays it
+      uint32_t left = channel.adsr_end_frame > channel.adsr_frame ? channel.adsr_end_frame - channel.adsr_frame : 0;
+      return left < count ? left + 1 : count;
+    }
+    return count;
+  }
+
+  // Scales a channel's summed waveforms into the mix. Dividing by a
+  // constant lets the compiler avoid a division per frame
+  template<int WAVEFORM_COUNT>
+  static void mix_channel(int32_t *mix, const int32_t *wave, const uint32_t *levels, uint16_t volume, uint32_t count) {
+    for(uint32_t i = 0; i < count; i++) {
+      int32_t channel_sample = wave[i] / WAVEFORM_COUNT;
+      channel_sample = mul_q16(channel_sample, levels[i] >> 8);
+      mix[i] += mul_q16(channel_sample, volume);
+    }
+  }
+
+  void PicoSynth::render(int16_t *samples, size_t count) {
+    while(count > 0) {
+      uint32_t n = count < RENDER_BLOCK ? count : RENDER_BLOCK;
+      render_block(samples, n);
+      samples += n;
+      count -= n;
+    }
+  }
+
+  // Renders up to RENDER_BLOCK frames a channel at a time, giving exactly
+  // what get_audio_frame() would. Noise comes from a generator shared by
+  // every channel, so where each channel's waveform wraps is found first and
+  // noise drawn for those wraps in the order get_audio_frame() would draw
+  // it. Then each channel's envelope is stepped a phase at a time and its
+  // waveforms added up a whole block at a time
+  void PicoSynth::render_block(int16_t *samples, uint32_t count) {
+    static_assert(RENDER_BLOCK <= 32, "wraps holds a bit per frame");
+
+    // a wave buffer callback can change anything part way through a block,
+    // so only frame by frame is certain to match
+    for(uint c = 0; c < CHANNEL_COUNT; c++) {
+      auto &channel = channels[c];
+      if(channel.adsr_phase != ADSRPhase::OFF && (channel.waveforms & Waveform::WAVE) && channel.wave_buffer_callback) {
+        for(uint32_t i = 0; i < count; i++) {
+          samples[i] = get_audio_frame();
+        }
+        return;
+      }
+    }
+
+    auto &increments = scratch.increments;
+    auto &frames = scratch.frames;
+    auto &wraps = scratch.wraps;
+    uint32_t any_wraps = 0;
+
+    for(uint c = 0; c < CHANNEL_COUNT; c++) {
+      auto &channel = channels[c];
+      increments[c] = ((channel.frequency * 256) << 8) / sample_rate;
+      frames[c] = active_frames(channel, count);
+
+      uint32_t offset = channel.waveform_offset;
+      uint32_t wrap = 0;
+      for(uint32_t i = 0; i < frames[c]; i++) {
+        offset += increments[c];
+        wrap |= ((offset >> 16) & 1) << i;
+        offset &= 0xffff;
+      }
+      wraps[c] = wrap;
+      any_wraps |= wrap;
+    }
+
+    // the noise each channel plays, starting with what it had and then
+    // each value it draws in turn
+    auto &noise = scratch.noise;
+    auto &draws = scratch.draws;
+    for(uint c = 0; c < CHANNEL_COUNT; c++) {
+      noise[c][0] = channels[c].noise;
+      draws[c] = 0;
+    }
+
+    while(any_wraps) {
+      uint32_t i = __builtin_ctz(any_wraps);
+      any_wraps &= any_wraps - 1;
+      for(uint c = 0; c < CHANNEL_COUNT; c++) {
+        if(wraps[c] & (1u << i)) {
+          channels[c].noise = prng_normal();
+          noise[c][++draws[c]] = channels[c].noise;
+        }
+      }
+    }
+
+    auto &mix = scratch.mix;
+    for(uint32_t i = 0; i < count; i++) {
+      mix[i] = 0;
+    }
+    bool mix_64bit = false;
+
+    for(uint c = 0; c < CHANNEL_COUNT; c++) {
+      auto &channel = channels[c];
+      const uint32_t n = frames[c];
+      const uint32_t increment = increments[c];
+      uint32_t offset = channel.waveform_offset;
+
+      // step the envelope a phase at a time, noting the waveform position
+      // and level of each frame
+      auto &offsets = scratch.offsets;
+      auto &levels = scratch.levels;
+      uint32_t levels_or = 0;
+      uint32_t i = 0;
+      while(i < n) {
+        if((channel.adsr_frame >= channel.adsr_end_frame) && (channel.adsr_phase != ADSRPhase::SUSTAIN)) {
+          switch (channel.adsr_phase) {
+            case ADSRPhase::ATTACK:
+              channel.trigger_decay();
+              break;
+            case ADSRPhase::DECAY:
+              channel.trigger_sustain();
+              break;
+            case ADSRPhase::RELEASE:
+              channel.off();
+              break;
+            default:
+              break;
+          }
+        }
+
+        // frames until the phase ends, or the last frame if it just switched off
+        uint32_t run = n - i;
+        if(channel.adsr_phase != ADSRPhase::SUSTAIN && channel.adsr_phase != ADSRPhase::OFF) {
+          uint32_t left = channel.adsr_end_frame - channel.adsr_frame;
+          run = left < run ? left : run;
+        }
+
+        uint32_t level = channel.adsr_level;
+        const int32_t step = channel.adsr_step;
+        for(uint32_t end = i + run; i < end; i++) {
+          level += step;
+          levels[i] = level;
+          levels_or |= level;
+          offset = (offset + increment) & 0xffff;
+          offsets[i] = offset;
+        }
+        channel.adsr_level = level;
+        channel.adsr_frame += run;
+      }
+
+      // it carries on counting while switched off, without wrapping
+      channel.waveform_offset = offset + increment * (count - n);
+
+      if(n == 0 || !channel.waveforms) {
+        continue;
+      }
+
+      // add up the channel's waveforms for the block
+      auto &wave = scratch.wave;
+      for(i = 0; i < n; i++) {
+        wave[i] = 0;
+      }
+      uint8_t waveform_count = 0;
+
+      if(channel.waveforms & Waveform::NOISE) {
+        const int16_t *value = noise[c];
+        for(i = 0; i < n; i++) {
+          if(wraps[c] & (1u << i)) {
+            value++;
+          }
+          wave[i] += *value;
+        }
+        waveform_count++;
+      }
+
+      if(channel.waveforms & Waveform::SAW) {
+        for(i = 0; i < n; i++) {
+          wave[i] += (int32_t)offsets[i] - 0x7fff;
+        }
+        waveform_count++;
+      }
+
+      // creates a triangle wave of ^
+      if(channel.waveforms & Waveform::TRIANGLE) {
+        for(i = 0; i < n; i++) {
+          if(offsets[i] < 0x7fff) { // initial quarter up slope
+            wave[i] += int32_t(offsets[i] * 2) - int32_t(0x7fff);
+          }
+          else { // final quarter up slope
+            wave[i] += int32_t(0x7fff) - ((int32_t(offsets[i]) - int32_t(0x7fff)) * 2);
+          }
+        }
+        waveform_count++;
+      }
+
+      if(channel.waveforms & Waveform::SQUARE) {
+        for(i = 0; i < n; i++) {
+          wave[i] += (offsets[i] < channel.pulse_width) ? 0x7fff : -0x7fff;
+        }
+        waveform_count++;
+      }
+
+      if(channel.waveforms & Waveform::SINE) {
+        for(i = 0; i < n; i++) {
+          wave[i] += sine_waveform[offsets[i] >> 8];
+        }
+        waveform_count++;
+      }
+
+      if(channel.waveforms & Waveform::WAVE) {
+        // no callback, checked above
+        for(i = 0; i < n; i++) {
+          wave[i] += channel.wave_buffer[channel.wave_buf_pos];
+          if(++channel.wave_buf_pos == 64) {
+            channel.wave_buf_pos = 0;
+          }
+        }
+        waveform_count++;
+      }
+
+      // apply the envelope and channel volume, then combine into the mix.
+      // Levels are at most 24 bits unless set by hand, keeping the
+      // products in 32 bits
+      if(levels_or <= 0xffffff) {
+        switch(waveform_count) {
+          case 1: mix_channel<1>(mix, wave, levels, channel.volume, n); continue;
+          case 2: mix_channel<2>(mix, wave, levels, channel.volume, n); continue;
+          case 3: mix_channel<3>(mix, wave, levels, channel.volume, n); continue;
+          case 4: mix_channel<4>(mix, wave, levels, channel.volume, n); continue;
+          case 5: mix_channel<5>(mix, wave, levels, channel.volume, n); continue;
+          case 6: mix_channel<6>(mix, wave, levels, channel.volume, n); continue;
+          default: break;
+        }
+      }
+
+      for(i = 0; i < n; i++) {
+        int32_t channel_sample = wave[i] / waveform_count;
+        channel_sample = (int64_t(channel_sample) * int32_t(levels[i] >> 8)) >> 16;
+        channel_sample = (int64_t(channel_sample) * int32_t(channel.volume)) >> 16;
+        mix[i] += channel_sample;
+      }
+      mix_64bit = true;
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+      int32_t sample = mix_64bit ? int32_t((int64_t(mix[i]) * int32_t(volume)) >> 16) : mul_q16(mix[i], volume);
+
+      // clip result to 16-bit
+      samples[i] = sample <= -0x8000 ? -0x8000 : (sample > 0x7fff ? 0x7fff : sample);
+    }
+  }
+
 }
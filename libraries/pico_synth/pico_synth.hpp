@@ -7,6 +7,7 @@
 //#include <vector>
 //#include <functional>
 
+#include <stddef.h>
 #include "common/pimoroni_common.hpp"
 
 namespace pimoroni {
@@ -112,7 +113,30 @@ namespace pimoroni {
     AudioChannel channels[CHANNEL_COUNT];
 
     int16_t get_audio_frame();
+    // fills samples with the next count frames, exactly as that many calls
+    // to get_audio_frame() would, but a channel at a time for speed
+    void render(int16_t *samples, size_t count);
     bool is_audio_playing();
+
+  private:
+    // frames render() works on at once, kept small as it's called from
+    // audio interrupts
+    static const uint32_t RENDER_BLOCK = 16;
+    void render_block(int16_t *samples, uint32_t count);
+
+    // render_block() works in here rather than on the stack of whichever
+    // interrupt it runs from
+    struct {
+      uint32_t increments[CHANNEL_COUNT];
+      uint32_t frames[CHANNEL_COUNT];   // how many frames each channel plays before switching off
+      uint32_t wraps[CHANNEL_COUNT];    // bit i set if the waveform wraps on frame i, drawing new noise
+      uint32_t draws[CHANNEL_COUNT];
+      int16_t noise[CHANNEL_COUNT][RENDER_BLOCK + 1];
+      int32_t mix[RENDER_BLOCK];
+      int32_t wave[RENDER_BLOCK];
+      uint32_t levels[RENDER_BLOCK];
+      uint16_t offsets[RENDER_BLOCK];
+    } scratch;
   };
 
   constexpr float pi = 3.14159265358979323846f;
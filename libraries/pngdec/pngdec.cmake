@@ -0,0 +1,11 @@
+if(NOT TARGET pico_graphics)
+    include(${CMAKE_CURRENT_LIST_DIR}/../pico_graphics/pico_graphics.cmake)
+endif()
+
+add_library(pngdec
+    ${CMAKE_CURRENT_LIST_DIR}/pngdec.cpp
+)
+
+target_include_directories(pngdec INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+target_link_libraries(pngdec pico_graphics pico_stdlib)
@@ -0,0 +1,795 @@
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <new>
+
+#include "pngdec.hpp"
+
+namespace pimoroni {
+
+  static const uint32_t CHUNK_IHDR = 0x49484452;
+  static const uint32_t CHUNK_PLTE = 0x504c5445;
+  static const uint32_t CHUNK_TRNS = 0x74524e53;
+  static const uint32_t CHUNK_IDAT = 0x49444154;
+  static const uint32_t CHUNK_IEND = 0x49454e44;
+
+  static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+  static inline uint32_t read_be32(const uint8_t *p) {
+    return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+  }
+
+  // Adam7 pass origins and spacing, a non-interlaced image is a single pass
+  static const uint8_t adam7_x[7]  = {0, 4, 0, 2, 0, 1, 0};
+  static const uint8_t adam7_y[7]  = {0, 0, 4, 0, 2, 0, 1};
+  static const uint8_t adam7_dx[7] = {8, 8, 4, 4, 2, 2, 1};
+  static const uint8_t adam7_dy[7] = {8, 8, 8, 4, 4, 2, 2};
+
+
+  // Inflate (RFC 1951) reading straight out of the IDAT chunks and writing
+  // each byte to Output as it's produced, the only history kept is the
+  // sliding window the stream was compressed with
+  template<typename Output>
+  class Inflater {
+    static const uint FAST_BITS = 9;
+
+    struct Huffman {
+      uint16_t count[16];
+      uint16_t symbol[288];
+      uint16_t fast[1 << FAST_BITS]; // (length << 12) | symbol, or 0 for longer codes
+    };
+
+    PNGDecoder &png;
+    Output &out;
+
+    Huffman *tables;        // literal/length and distance tables of a dynamic block
+    uint8_t *window;
+    uint32_t window_mask;
+    uint32_t position = 0;  // total bytes output
+
+    uint32_t bits = 0;
+    uint32_t bit_count = 0;
+    uint32_t overrun = 0;   // bytes of padding supplied past the end of the data
+
+    // the tables of the current block, either tables or the fixed ones
+    const Huffman *lengths = nullptr;
+    const Huffman *distances = nullptr;
+
+  public:
+    bool error = false;
+
+    // the dynamic tables are over 3KB so they share the window's allocation
+    // rather than sitting on the stack
+    static size_t buffer_size(uint32_t window_size) {
+      return sizeof(Huffman) * 2 + window_size;
+    }
+
+    Inflater(PNGDecoder &png, Output &out, uint8_t *buffer, uint32_t window_size)
+      : png(png), out(out), tables((Huffman *)buffer), window(buffer + sizeof(Huffman) * 2), window_mask(window_size - 1) {}
+
+  private:
+    int next_byte() {
+      if(png.idat_remaining && png.input_position < png.input_length) {
+        png.idat_remaining--;
+        return png.in[png.input_position++];
+      }
+
+      // move on to the next IDAT chunk, skipping the CRC of this one
+      while(png.idat_remaining == 0) {
+        uint32_t length, type;
+        if(!png.skip_bytes(4) || !png.read_chunk_header(length, type) || type != CHUNK_IDAT) return -1;
+        png.idat_remaining = length;
+      }
+      if(png.input_position == png.input_length && png.fill() == 0) return -1;
+      png.idat_remaining--;
+      return png.in[png.input_position++];
+    }
+
+    inline void refill() {
+      while(bit_count <= 24) {
+        int b = next_byte();
+        if(b < 0) {
+          // keep going with zeros so a final code can be peeked at,
+          // but don't let a corrupt stream read on forever
+          if(++overrun > 4) error = true;
+          b = 0;
+        }
+        bits |= uint32_t(b) << bit_count;
+        bit_count += 8;
+      }
+    }
+
+    inline uint32_t get_bits(uint32_t n) {
+      if(bit_count < n) refill();
+      uint32_t v = bits & ((1u << n) - 1);
+      bits >>= n;
+      bit_count -= n;
+      return v;
+    }
+
+    inline void emit(uint8_t b) {
+      window[position++ & window_mask] = b;
+      out(b);
+    }
+
+    bool build(Huffman &h, const uint8_t *length, uint n) {
+      memset(h.count, 0, sizeof(h.count));
+      for(auto i = 0u; i < n; i++) h.count[length[i]]++;
+      h.count[0] = 0;
+
+      // reject over-subscribed codes, incomplete ones are allowed
+      int left = 1;
+      for(auto len = 1; len < 16; len++) {
+        left = (left << 1) - h.count[len];
+        if(left < 0) return false;
+      }
+
+      uint16_t offsets[16];
+      offsets[1] = 0;
+      for(auto len = 1; len < 15; len++) offsets[len + 1] = offsets[len] + h.count[len];
+      for(auto i = 0u; i < n; i++) {
+        if(length[i]) h.symbol[offsets[length[i]]++] = i;
+      }
+
+      // every code short enough gets an entry for each of its possible suffixes
+      memset(h.fast, 0, sizeof(h.fast));
+      uint32_t code = 0, index = 0;
+      for(auto len = 1u; len <= FAST_BITS; len++) {
+        for(auto i = 0u; i < h.count[len]; i++, index++, code++) {
+          uint32_t reversed = 0;
+          for(auto b = 0u; b < len; b++) reversed |= ((code >> b) & 1) << (len - 1 - b);
+          for(auto k = reversed; k < (1u << FAST_BITS); k += 1u << len) {
+            h.fast[k] = (len << 12) | h.symbol[index];
+          }
+        }
+        code <<= 1;
+      }
+
+      return true;
+    }
+
+    int decode(const Huffman &h) {
+      if(bit_count < 16) refill();
+
+      uint16_t entry = h.fast[bits & ((1u << FAST_BITS) - 1)];
+      if(entry) {
+        bits >>= entry >> 12;
+        bit_count -= entry >> 12;
+        return entry & 0xfff;
+      }
+
+      // canonical decode a bit at a time for the longer codes
+      int code = 0, first = 0, index = 0;
+      for(auto len = 1u; len < 16; len++) {
+        code |= (bits >> (len - 1)) & 1;
+        int count = h.count[len];
+        if(code - count < first) {
+          bits >>= len;
+          bit_count -= len;
+          return h.symbol[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+      }
+      error = true;
+      return -1;
+    }
+
+    bool stored() {
+      // stored blocks start on a byte boundary
+      get_bits(bit_count & 7);
+      uint32_t length = get_bits(16);
+      uint32_t check = get_bits(16);
+      if(length != (~check & 0xffff)) return false;
+
+      while(length-- && !error) emit(get_bits(8));
+      return !error;
+    }
+
+    bool codes() {
+      static const uint16_t length_base[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+      static const uint8_t length_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+      static const uint16_t distance_base[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+      static const uint8_t distance_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+      while(!error) {
+        int symbol = decode(*lengths);
+        if(symbol < 256) {
+          if(symbol < 0) return false;
+          emit(symbol);
+        } else if(symbol == 256) {
+          return true;
+        } else {
+          symbol -= 257;
+          if(symbol >= 29) return false;
+          uint32_t length = length_base[symbol] + get_bits(length_extra[symbol]);
+
+          symbol = decode(*distances);
+          if(symbol < 0 || symbol >= 30) return false;
+          uint32_t distance = distance_base[symbol] + get_bits(distance_extra[symbol]);
+          if(distance > position || distance > window_mask + 1) return false;
+
+          while(length--) emit(window[(position - distance) & window_mask]);
+        }
+      }
+      return false;
+    }
+
+    bool fixed() {
+      static bool built = false;
+      static Huffman fixed_lengths, fixed_distances;
+
+      if(!built) {
+        uint8_t length[288];
+        memset(length, 8, 144);
+        memset(length + 144, 9, 112);
+        memset(length + 256, 7, 24);
+        memset(length + 280, 8, 8);
+        build(fixed_lengths, length, 288);
+        memset(length, 5, 30);
+        build(fixed_distances, length, 30);
+        built = true;
+      }
+
+      lengths = &fixed_lengths;
+      distances = &fixed_distances;
+      return codes();
+    }
+
+    bool dynamic() {
+      static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+      uint32_t nlen = get_bits(5) + 257;
+      uint32_t ndist = get_bits(5) + 1;
+      uint32_t ncode = get_bits(4) + 4;
+      if(nlen > 286 || ndist > 30) return false;
+
+      uint8_t length[286 + 30];
+      memset(length, 0, 19);
+      for(auto i = 0u; i < ncode; i++) length[order[i]] = get_bits(3);
+      if(!build(tables[0], length, 19)) return false;
+
+      // the literal/length and distance code lengths are themselves coded
+      uint32_t i = 0;
+      while(i < nlen + ndist) {
+        int symbol = decode(tables[0]);
+        if(symbol < 0) return false;
+        if(symbol < 16) {
+          length[i++] = symbol;
+          continue;
+        }
+
+        uint8_t value = 0;
+        uint32_t repeat;
+        if(symbol == 16) {
+          if(i == 0) return false;
+          value = length[i - 1];
+          repeat = 3 + get_bits(2);
+        } else if(symbol == 17) {
+          repeat = 3 + get_bits(3);
+        } else {
+          repeat = 11 + get_bits(7);
+        }
+        if(i + repeat > nlen + ndist) return false;
+        while(repeat--) length[i++] = value;
+      }
+
+      if(length[256] == 0) return false;
+      if(!build(tables[0], length, nlen) || !build(tables[1], length + nlen, ndist)) return false;
+
+      lengths = &tables[0];
+      distances = &tables[1];
+      return codes();
+    }
+
+  public:
+    bool inflate() {
+      bool last;
+      do {
+        last = get_bits(1);
+        bool ok;
+        switch(get_bits(2)) {
+          case 0: ok = stored(); break;
+          case 1: ok = fixed(); break;
+          case 2: ok = dynamic(); break;
+          default: ok = false; break;
+        }
+        if(!ok || error) return false;
+      } while(!last);
+      return true;
+    }
+  };
+
+
+  // Collects inflated bytes into rows, undoes the row filters and converts
+  // each finished row to RGBA for the row callback
+  class RowDecoder {
+    const PNGDecoder &png;
+    PNGDecoder::row_func &rows;
+    uint8_t flags;
+
+    uint8_t *current;   // filter byte followed by the row
+    uint8_t *previous;  // the previous unfiltered row of this pass
+    uint8_t *rgba;
+
+    uint32_t bits_per_pixel;
+    uint32_t pixel_bytes;  // bytes to the corresponding byte of the previous pixel
+
+    int pass = -1;
+    int32_t pass_width = 0;
+    int32_t pass_height = 0;
+    int32_t row = 0;
+    uint32_t row_bytes = 0;
+    uint32_t filled = 0;
+
+  public:
+    bool done = false;
+    bool error = false;
+
+    RowDecoder(const PNGDecoder &png, PNGDecoder::row_func &rows, uint8_t flags, uint8_t *buffer, uint32_t bits_per_pixel)
+      : png(png), rows(rows), flags(flags), bits_per_pixel(bits_per_pixel) {
+      uint32_t stride = (png.get_width() * bits_per_pixel + 7) / 8;
+      current = buffer;
+      previous = buffer + stride + 1;
+      rgba = previous + stride;
+      pixel_bytes = std::max<uint32_t>(1, bits_per_pixel / 8);
+      next_pass();
+    }
+
+    static uint32_t buffer_size(int32_t width, uint32_t bits_per_pixel) {
+      uint32_t stride = (width * bits_per_pixel + 7) / 8;
+      return (stride + 1) + stride + width * 4;
+    }
+
+    inline void operator()(uint8_t b) {
+      if(done) return;
+      current[filled++] = b;
+      if(filled == row_bytes) end_row();
+    }
+
+  private:
+    void next_pass() {
+      int last_pass = png.is_interlaced() ? 6 : 0;
+      while(++pass <= last_pass) {
+        if(png.is_interlaced()) {
+          pass_width = (png.get_width() - adam7_x[pass] + adam7_dx[pass] - 1) / adam7_dx[pass];
+          pass_height = (png.get_height() - adam7_y[pass] + adam7_dy[pass] - 1) / adam7_dy[pass];
+        } else {
+          pass_width = png.get_width();
+          pass_height = png.get_height();
+        }
+
+        // passes with no pixels aren't stored at all
+        if(pass_width > 0 && pass_height > 0) {
+          row = 0;
+          row_bytes = (pass_width * bits_per_pixel + 7) / 8 + 1;
+          memset(previous, 0, row_bytes - 1);
+          return;
+        }
+      }
+      done = true;
+    }
+
+    static inline uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+      int p = a + b - c;
+      int pa = abs(p - a);
+      int pb = abs(p - b);
+      int pc = abs(p - c);
+      if(pa <= pb && pa <= pc) return a;
+      return pb <= pc ? b : c;
+    }
+
+    void unfilter() {
+      uint8_t *r = current + 1;
+      const uint8_t *p = previous;
+      uint32_t n = row_bytes - 1;
+      uint32_t bpp = pixel_bytes;
+
+      switch(current[0]) {
+        case 0:
+          break;
+        case 1:
+          for(auto i = bpp; i < n; i++) r[i] += r[i - bpp];
+          break;
+        case 2:
+          for(auto i = 0u; i < n; i++) r[i] += p[i];
+          break;
+        case 3:
+          for(auto i = 0u; i < bpp; i++) r[i] += p[i] >> 1;
+          for(auto i = bpp; i < n; i++) r[i] += (r[i - bpp] + p[i]) >> 1;
+          break;
+        case 4:
+          for(auto i = 0u; i < bpp; i++) r[i] += p[i];
+          for(auto i = bpp; i < n; i++) r[i] += paeth(r[i - bpp], p[i], p[i - bpp]);
+          break;
+        default:
+          error = true;
+          break;
+      }
+    }
+
+    void to_rgba() {
+      const uint8_t *r = current + 1;
+      uint8_t *o = rgba;
+      uint8_t depth = png.get_bit_depth();
+      bool key = png.has_key;
+
+      switch(png.get_color_type()) {
+        case PNGDecoder::COLOR_GREY:
+          if(depth < 8) {
+            // scale packed samples up to the full 0-255 range
+            uint8_t scale = depth == 1 ? 255 : depth == 2 ? 85 : 17;
+            uint8_t mask = (1 << depth) - 1;
+            for(auto x = 0; x < pass_width; x++) {
+              uint32_t bit = x * depth;
+              uint8_t v = (r[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+              o[0] = o[1] = o[2] = v * scale;
+              o[3] = (key && v == png.key[0]) ? 0 : 255;
+              o += 4;
+            }
+          } else {
+            uint32_t step = depth / 8;
+            for(auto x = 0; x < pass_width; x++, r += step) {
+              uint16_t v = step == 2 ? (r[0] << 8) | r[1] : r[0];
+              o[0] = o[1] = o[2] = r[0];
+              o[3] = (key && v == png.key[0]) ? 0 : 255;
+              o += 4;
+            }
+          }
+          break;
+
+        case PNGDecoder::COLOR_RGB: {
+          uint32_t step = depth / 8;
+          for(auto x = 0; x < pass_width; x++, r += step * 3) {
+            o[0] = r[0];
+            o[1] = r[step];
+            o[2] = r[step * 2];
+            o[3] = 255;
+            if(key) {
+              uint16_t cr = step == 2 ? (r[0] << 8) | r[1] : r[0];
+              uint16_t cg = step == 2 ? (r[2] << 8) | r[3] : r[1];
+              uint16_t cb = step == 2 ? (r[4] << 8) | r[5] : r[2];
+              if(cr == png.key[0] && cg == png.key[1] && cb == png.key[2]) o[3] = 0;
+            }
+            o += 4;
+          }
+          break;
+        }
+
+        case PNGDecoder::COLOR_PALETTE: {
+          uint8_t mask = (1 << depth) - 1;
+          bool direct = flags & PNGDecoder::PNG_PALETTE_DIRECT;
+          for(auto x = 0; x < pass_width; x++) {
+            uint32_t bit = x * depth;
+            uint8_t i = (r[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+            memcpy(o, png.palette[i], 4);
+            // in direct mode the index is passed on in place of red
+            if(direct) o[0] = i;
+            o += 4;
+          }
+          break;
+        }
+
+        case PNGDecoder::COLOR_GREY_ALPHA: {
+          uint32_t step = depth / 8;
+          for(auto x = 0; x < pass_width; x++, r += step * 2) {
+            o[0] = o[1] = o[2] = r[0];
+            o[3] = r[step];
+            o += 4;
+          }
+          break;
+        }
+
+        case PNGDecoder::COLOR_RGBA: {
+          if(depth == 8) {
+            memcpy(o, r, pass_width * 4);
+          } else {
+            for(auto x = 0; x < pass_width; x++, r += 8) {
+              o[0] = r[0];
+              o[1] = r[2];
+              o[2] = r[4];
+              o[3] = r[6];
+              o += 4;
+            }
+          }
+          break;
+        }
+      }
+    }
+
+    void end_row() {
+      filled = 0;
+      unfilter();
+      if(error) {
+        done = true;
+        return;
+      }
+      to_rgba();
+
+      int32_t x = 0, y = row, step = 1;
+      if(png.is_interlaced()) {
+        x = adam7_x[pass];
+        y = adam7_y[pass] + row * adam7_dy[pass];
+        step = adam7_dx[pass];
+      }
+      rows(x, y, step, rgba, pass_width);
+
+      // the row we just finished is the previous row for the next one
+      memcpy(previous, current + 1, row_bytes - 1);
+
+      if(++row == pass_height) next_pass();
+    }
+  };
+
+
+  int32_t PNGDecoder::fill() {
+    // memory sources are in the buffer from the start
+    if(!read) return 0;
+
+    int32_t n = read(buffer, INPUT_BUFFER_SIZE);
+    if(n < 0) {
+      read_failed = true;
+      n = 0;
+    }
+    in = buffer;
+    input_position = 0;
+    input_length = n;
+    return n;
+  }
+
+  bool PNGDecoder::read_bytes(uint8_t *dest, uint32_t length) {
+    while(length) {
+      if(input_position == input_length && fill() == 0) return false;
+      uint32_t n = std::min(length, uint32_t(input_length - input_position));
+      memcpy(dest, in + input_position, n);
+      input_position += n;
+      dest += n;
+      length -= n;
+    }
+    return true;
+  }
+
+  bool PNGDecoder::skip_bytes(uint32_t length) {
+    while(length) {
+      if(input_position == input_length && fill() == 0) return false;
+      uint32_t n = std::min(length, uint32_t(input_length - input_position));
+      input_position += n;
+      length -= n;
+    }
+    return true;
+  }
+
+  bool PNGDecoder::read_chunk_header(uint32_t &length, uint32_t &type) {
+    uint8_t header[8];
+    if(!read_bytes(header, 8)) return false;
+    length = read_be32(header);
+    type = read_be32(header + 4);
+    return length < 0x80000000;
+  }
+
+  bool PNGDecoder::read_header() {
+    uint8_t signature[8];
+    if(!read_bytes(signature, 8) || memcmp(signature, SIGNATURE, 8) != 0) return false;
+
+    uint32_t length, type;
+    if(!read_chunk_header(length, type) || type != CHUNK_IHDR || length != 13) return false;
+
+    uint8_t ihdr[13];
+    if(!read_bytes(ihdr, 13) || !skip_bytes(4)) return false;
+    width = read_be32(ihdr);
+    height = read_be32(ihdr + 4);
+    bit_depth = ihdr[8];
+    color_type = ihdr[9];
+    interlaced = ihdr[12] == 1;
+
+    // compression, filter method and interlace must be ones we know
+    if(ihdr[10] != 0 || ihdr[11] != 0 || ihdr[12] > 1) return false;
+    if(width <= 0 || height <= 0 || width > 0xffff || height > 0xffff) return false;
+
+    bool valid_depth;
+    switch(color_type) {
+      case COLOR_GREY:    valid_depth = bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8 || bit_depth == 16; break;
+      case COLOR_PALETTE: valid_depth = bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8; break;
+      case COLOR_RGB:
+      case COLOR_GREY_ALPHA:
+      case COLOR_RGBA:    valid_depth = bit_depth == 8 || bit_depth == 16; break;
+      default:            valid_depth = false; break;
+    }
+    if(!valid_depth) return false;
+
+    // everything up to the first IDAT, we only care about the palette and transparency
+    while(true) {
+      if(!read_chunk_header(length, type)) return false;
+
+      if(type == CHUNK_IDAT) {
+        idat_remaining = length;
+        return color_type != COLOR_PALETTE || palette_size > 0;
+      } else if(type == CHUNK_IEND) {
+        return false;
+      } else if(type == CHUNK_PLTE && length % 3 == 0 && length <= 768) {
+        uint8_t entry[3];
+        palette_size = length / 3;
+        for(auto i = 0u; i < palette_size; i++) {
+          if(!read_bytes(entry, 3)) return false;
+          palette[i][0] = entry[0];
+          palette[i][1] = entry[1];
+          palette[i][2] = entry[2];
+          palette[i][3] = 255;
+        }
+      } else if(type == CHUNK_TRNS && color_type == COLOR_PALETTE && length <= 256) {
+        for(auto i = 0u; i < length; i++) {
+          if(!read_bytes(&palette[i][3], 1)) return false;
+        }
+      } else if(type == CHUNK_TRNS && (color_type == COLOR_GREY || color_type == COLOR_RGB) && length == (color_type == COLOR_GREY ? 2u : 6u)) {
+        uint8_t k[6];
+        if(!read_bytes(k, length)) return false;
+        for(auto i = 0u; i < length / 2; i++) key[i] = (k[i * 2] << 8) | k[i * 2 + 1];
+        has_key = true;
+      } else {
+        if(!skip_bytes(length)) return false;
+      }
+
+      if(!skip_bytes(4)) return false; // CRC
+    }
+  }
+
+  bool PNGDecoder::open(const uint8_t *data, uint32_t length) {
+    read = nullptr;
+    in = data;
+    input_position = 0;
+    input_length = length;
+    return reset();
+  }
+
+  bool PNGDecoder::open(read_func read) {
+    this->read = read;
+    in = buffer;
+    input_position = 0;
+    input_length = 0;
+    return reset();
+  }
+
+  bool PNGDecoder::reset() {
+    read_failed = false;
+    palette_size = 0;
+    has_key = false;
+    idat_remaining = 0;
+    // palette entries past the end of PLTE are drawn opaque black
+    memset(palette, 0, sizeof(palette));
+    for(auto &entry : palette) entry[3] = 255;
+
+    header_read = read_header();
+    return header_read;
+  }
+
+  bool PNGDecoder::has_alpha() const {
+    return color_type == COLOR_GREY_ALPHA || color_type == COLOR_RGBA || has_key || (color_type == COLOR_PALETTE && palette_size > 0);
+  }
+
+  PNGDecoder::Result PNGDecoder::decode(row_func rows, uint8_t flags) {
+    if(!header_read) return read_failed ? PNG_READ_ERROR : PNG_INVALID_FILE;
+    header_read = false;
+
+    // the zlib header gives the window size the stream was compressed with
+    uint8_t zlib[2];
+    if(idat_remaining < 2 || !read_bytes(zlib, 2)) return PNG_INVALID_FILE;
+    idat_remaining -= 2;
+    if((zlib[0] & 0x0f) != 8 || ((zlib[0] << 8) | zlib[1]) % 31 != 0) return PNG_INVALID_FILE;
+    if(zlib[1] & 0x20) return PNG_UNSUPPORTED; // preset dictionary
+    uint32_t window_size = 1u << ((zlib[0] >> 4) + 8);
+    if(window_size > 32768) return PNG_INVALID_FILE;
+
+    uint8_t channels[7] = {1, 0, 3, 1, 2, 0, 4};
+    uint32_t bits_per_pixel = channels[color_type] * bit_depth;
+
+    std::unique_ptr<uint8_t[]> inflate_buffer(new (std::nothrow) uint8_t[Inflater<RowDecoder>::buffer_size(window_size)]);
+    std::unique_ptr<uint8_t[]> row_buffer(new (std::nothrow) uint8_t[RowDecoder::buffer_size(width, bits_per_pixel)]);
+    if(!inflate_buffer || !row_buffer) return PNG_NO_MEMORY;
+
+    RowDecoder row_decoder(*this, rows, flags, row_buffer.get(), bits_per_pixel);
+    Inflater<RowDecoder> inflater(*this, row_decoder, inflate_buffer.get(), window_size);
+
+    bool ok = inflater.inflate();
+
+    if(read_failed) return PNG_READ_ERROR;
+    if(!ok || row_decoder.error || !row_decoder.done) return PNG_INVALID_FILE;
+    return PNG_OK;
+  }
+
+  PNGDecoder::Result PNGDecoder::decode(PicoGraphics *graphics, const Point &p, uint8_t flags) {
+    const Rect &clip = graphics->clip;
+    int32_t clip_right = clip.x + clip.w;
+
+    row_func rows = [&](int32_t x, int32_t y, int32_t step, const uint8_t *rgba, int32_t count) {
+      y += p.y;
+      x += p.x;
+      if(y < clip.y || y >= clip.y + clip.h) return;
+
+      // clip the row to the pixels that land inside the clip rectangle
+      int32_t first = x < clip.x ? (clip.x - x + step - 1) / step : 0;
+      int32_t last = x + (count - 1) * step >= clip_right ? (clip_right - x + step - 1) / step : count;
+      if(first >= last) return;
+      rgba += first * 4;
+      x += first * step;
+      count = last - first;
+
+      switch(graphics->pen_type) {
+        case PicoGraphics::PEN_RGB565: {
+          RGB565 *dst = (RGB565 *)graphics->frame_buffer + y * graphics->bounds.w + x;
+          for(auto i = 0; i < count; i++, rgba += 4, dst += step) {
+            uint8_t a = rgba[3];
+            if(a == 255) {
+              *dst = RGB(rgba[0], rgba[1], rgba[2]).to_rgb565();
+            } else if(a) {
+              RGB d((RGB565)*dst);
+              *dst = RGB(
+                d.r + (((rgba[0] - d.r) * a) >> 8),
+                d.g + (((rgba[1] - d.g) * a) >> 8),
+                d.b + (((rgba[2] - d.b) * a) >> 8)
+              ).to_rgb565();
+            }
+          }
+          break;
+        }
+        case PicoGraphics::PEN_RGB888: {
+          RGB888 *dst = (RGB888 *)graphics->frame_buffer + y * graphics->bounds.w + x;
+          for(auto i = 0; i < count; i++, rgba += 4, dst += step) {
+            uint8_t a = rgba[3];
+            if(a == 255) {
+              *dst = (rgba[0] << 16) | (rgba[1] << 8) | rgba[2];
+            } else if(a) {
+              RGB d((uint)*dst);
+              *dst = RGB(
+                d.r + (((rgba[0] - d.r) * a) >> 8),
+                d.g + (((rgba[1] - d.g) * a) >> 8),
+                d.b + (((rgba[2] - d.b) * a) >> 8)
+              ).to_rgb888();
+            }
+          }
+          break;
+        }
+        default: {
+          if((flags & PNG_PALETTE_DIRECT) && color_type == COLOR_PALETTE) {
+            for(auto i = 0; i < count; i++, rgba += 4, x += step) {
+              if(rgba[3] < 128) continue;
+              graphics->set_pen(rgba[0]);
+              graphics->set_pixel(Point(x, y));
+            }
+            break;
+          }
+
+          // runs of opaque pixels are converted to RGB565 and handed to the
+          // pen a span at a time, which takes care of dithering (or not)
+          bool dither = !(flags & PNG_NO_DITHER);
+          RGB565 span[64];
+          int32_t length = 0;
+          int32_t span_x = x;
+          for(auto i = 0; i < count; i++, rgba += 4, x += step) {
+            // interlaced passes skip pixels so only ever have spans of one
+            if(length && (rgba[3] < 128 || length == 64 || step != 1)) {
+              graphics->set_pixel_span_rgb565(Point(span_x, y), length, span, dither);
+              length = 0;
+            }
+            if(rgba[3] < 128) continue;
+            if(!length) span_x = x;
+            span[length++] = RGB(rgba[0], rgba[1], rgba[2]).to_rgb565();
+          }
+          if(length) graphics->set_pixel_span_rgb565(Point(span_x, y), length, span, dither);
+          break;
+        }
+      }
+    };
+
+    return decode(rows, flags);
+  }
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+// Streaming PNG decoder
+//
+// Images are read a chunk at a time and inflated through a sliding window no
+// larger than the one the encoder asked for (at most 32KB). Each row is
+// unfiltered as soon as it is complete and handed on, so only two rows of
+// the image are ever held in memory regardless of its height.
+//
+// All colour types and bit depths are supported, along with palettes,
+// tRNS transparency and Adam7 interlacing. CRCs and the zlib checksum are
+// not verified.
+namespace pimoroni {
+
+  class PNGDecoder {
+  public:
+    enum Result : int8_t {
+      PNG_OK = 0,
+      PNG_INVALID_FILE,   // not a PNG, or a truncated/corrupt one
+      PNG_UNSUPPORTED,    // a valid PNG we can't decode
+      PNG_READ_ERROR,
+      PNG_NO_MEMORY,
+    };
+
+    enum Flags : uint8_t {
+      // palette images are drawn with their palette indices as pen numbers,
+      // for P4/P8 buffers whose palette has been set up to match the image
+      PNG_PALETTE_DIRECT = 1,
+      // pick the closest palette colour instead of dithering on P4/P8/3Bit/Inky7
+      PNG_NO_DITHER = 2,
+    };
+
+    // fill buffer with up to length bytes, returning the number read or -1 on error
+    typedef std::function<int32_t(uint8_t *buffer, int32_t length)> read_func;
+
+    // called for every decoded row with count RGBA8888 pixels, which belong at
+    // x, x + step, x + 2 * step... on row y (step is only > 1 for interlaced images)
+    typedef std::function<void(int32_t x, int32_t y, int32_t step, const uint8_t *rgba, int32_t count)> row_func;
+
+    static const int32_t INPUT_BUFFER_SIZE = 512;
+
+    enum ColorType : uint8_t {
+      COLOR_GREY = 0,
+      COLOR_RGB = 2,
+      COLOR_PALETTE = 3,
+      COLOR_GREY_ALPHA = 4,
+      COLOR_RGBA = 6,
+    };
+
+  private:
+    read_func read;
+
+    // memory sources are read in place, anything else through the buffer
+    const uint8_t *in = nullptr;
+    uint8_t buffer[INPUT_BUFFER_SIZE];
+    int32_t input_position = 0;
+    int32_t input_length = 0;
+    bool read_failed = false;
+
+    // image header
+    int32_t width = 0;
+    int32_t height = 0;
+    uint8_t bit_depth = 0;
+    uint8_t color_type = 0;
+    bool interlaced = false;
+
+    // palette and transparency, a tRNS chunk on a grey or RGB image is a
+    // single colour key rather than per-entry alpha
+    uint8_t palette[256][4];
+    uint16_t palette_size = 0;
+    bool has_key = false;
+    uint16_t key[3];
+
+    // bytes left in the current IDAT chunk
+    uint32_t idat_remaining = 0;
+    bool header_read = false;
+
+    int32_t fill();
+    bool read_bytes(uint8_t *buffer, uint32_t length);
+    bool skip_bytes(uint32_t length);
+    bool read_chunk_header(uint32_t &length, uint32_t &type);
+    bool read_header();
+    bool reset();
+
+    template<typename Output> friend class Inflater;
+    friend class RowDecoder;
+
+  public:
+    bool open(const uint8_t *data, uint32_t length);
+    bool open(read_func read);
+
+    int32_t get_width() const {return width;}
+    int32_t get_height() const {return height;}
+    uint8_t get_bit_depth() const {return bit_depth;}
+    uint8_t get_color_type() const {return color_type;}
+    bool is_interlaced() const {return interlaced;}
+    bool has_alpha() const;
+
+    // decode the image handing each row to the callback
+    Result decode(row_func rows, uint8_t flags = 0);
+
+    // decode the image straight into a PicoGraphics surface with its top
+    // left corner at p, respecting the clip rectangle and blending alpha
+    // into RGB565/RGB888 buffers. Other buffers draw pixels that are at
+    // least half opaque
+    Result decode(PicoGraphics *graphics, const Point &p, uint8_t flags = 0);
+  };
+
+}
@@ -0,0 +1,7 @@
+add_library(screenshot
+    ${CMAKE_CURRENT_LIST_DIR}/screenshot.cpp
+)
+
+target_include_directories(screenshot INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+target_link_libraries(screenshot fatfs pico_graphics pico_stdlib)
@@ -0,0 +1,263 @@
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+#include "screenshot.hpp"
+
+namespace pimoroni {
+
+  // CRC-32 a nibble at a time, a 64 byte table is plenty for a few rows
+  static const uint32_t crc_table[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+  };
+
+  static const uint8_t png_signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+  // stored deflate blocks hold at most 64K - 1 bytes
+  static const uint32_t STORED_BLOCK_SIZE = 65535;
+
+  static void be32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+  }
+
+  static void le32(uint8_t *p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+  }
+
+  static void le16(uint8_t *p, uint16_t v) {
+    p[0] = v; p[1] = v >> 8;
+  }
+
+  bool Screenshot::flush() {
+    if(buffered && !write_failed) {
+      UINT written = 0;
+      if(f_write(&file, buffer.get(), buffered, &written) != FR_OK || written != buffered) {
+        write_failed = true;
+      }
+      stats.bytes += written;
+    }
+    buffered = 0;
+    return !write_failed;
+  }
+
+  void Screenshot::put(const void *data, uint32_t length) {
+    const uint8_t *src = (const uint8_t *)data;
+    while(length) {
+      uint32_t n = std::min(length, buffer_size - buffered);
+      memcpy(buffer.get() + buffered, src, n);
+      buffered += n;
+      src += n;
+      length -= n;
+
+      // only ever write whole buffers, so writes stay sector aligned until the last
+      if(buffered == buffer_size) flush();
+    }
+  }
+
+  void Screenshot::put_checked(const void *data, uint32_t length) {
+    const uint8_t *p = (const uint8_t *)data;
+    for(auto i = 0u; i < length; i++) {
+      crc ^= p[i];
+      crc = crc_table[crc & 0xf] ^ (crc >> 4);
+      crc = crc_table[crc & 0xf] ^ (crc >> 4);
+    }
+    put(data, length);
+  }
+
+  void Screenshot::put_image_data(const uint8_t *data, uint32_t length) {
+    while(length) {
+      if(block_remaining == 0) {
+        block_remaining = std::min(data_remaining, STORED_BLOCK_SIZE);
+        uint8_t header[5];
+        header[0] = block_remaining == data_remaining ? 1 : 0; // last block?
+        le16(header + 1, block_remaining);
+        le16(header + 3, ~block_remaining);
+        put_checked(header, sizeof(header));
+      }
+
+      uint32_t n = std::min(length, block_remaining);
+
+      // Adler-32, taking the modulo only as often as it could overflow
+      for(uint32_t i = 0; i < n;) {
+        uint32_t end = std::min(n, i + 5552);
+        for(; i < end; i++) {
+          adler_a += data[i];
+          adler_b += adler_a;
+        }
+        adler_a %= 65521;
+        adler_b %= 65521;
+      }
+
+      put_checked(data, n);
+      data += n;
+      length -= n;
+      block_remaining -= n;
+      data_remaining -= n;
+    }
+  }
+
+  void Screenshot::write_bmp_header() {
+    uint32_t row_bytes = encoded_length;
+    uint32_t image_size = row_bytes * graphics.bounds.h;
+
+    uint8_t header[54] = {'B', 'M'};
+    le32(header + 2, sizeof(header) + image_size);
+    le32(header + 10, sizeof(header));          // offset of the pixels
+    le32(header + 14, 40);                      // BITMAPINFOHEADER
+    le32(header + 18, graphics.bounds.w);
+    le32(header + 22, -graphics.bounds.h);      // negative for top down rows
+    le16(header + 26, 1);                       // planes
+    le16(header + 28, 24);                      // bits per pixel
+    le32(header + 34, image_size);
+    le32(header + 38, 2835);                    // 72 dpi
+    le32(header + 42, 2835);
+    put(header, sizeof(header));
+  }
+
+  void Screenshot::write_png_header() {
+    put(png_signature, sizeof(png_signature));
+
+    uint8_t ihdr[17] = {'I', 'H', 'D', 'R'};
+    be32(ihdr + 4, graphics.bounds.w);
+    be32(ihdr + 8, graphics.bounds.h);
+    ihdr[12] = 8;   // bits per channel
+    ihdr[13] = 2;   // RGB
+    uint8_t v[4];
+    be32(v, 13);
+    put(v, 4);
+    crc = 0xffffffff;
+    put_checked(ihdr, sizeof(ihdr));
+    be32(v, ~crc);
+    put(v, 4);
+
+    // the whole image goes in one IDAT chunk, its size is known up front
+    // as nothing is compressed
+    data_remaining = graphics.bounds.h * encoded_length;
+    uint32_t blocks = (data_remaining + STORED_BLOCK_SIZE - 1) / STORED_BLOCK_SIZE;
+    be32(v, 2 + blocks * 5 + data_remaining + 4);
+    put(v, 4);
+    crc = 0xffffffff;
+    const uint8_t idat[6] = {'I', 'D', 'A', 'T', 0x78, 0x01}; // and the zlib header
+    put_checked(idat, sizeof(idat));
+    block_remaining = 0;
+    adler_a = 1;
+    adler_b = 0;
+  }
+
+  void Screenshot::write_png_trailer() {
+    uint8_t v[4];
+    be32(v, (adler_b << 16) | adler_a);
+    put_checked(v, 4);
+    be32(v, ~crc);
+    put(v, 4);
+
+    const uint8_t iend[12] = {0, 0, 0, 0, 'I', 'E', 'N', 'D', 0xae, 0x42, 0x60, 0x82};
+    put(iend, sizeof(iend));
+  }
+
+  void Screenshot::encode_row() {
+    const RGB888 *src = pixels.get();
+    uint8_t *dest = encoded.get();
+    if(format == FORMAT_PNG) {
+      *dest++ = 0;  // no filter
+      for(auto x = 0; x < graphics.bounds.w; x++) {
+        RGB888 c = src[x];
+        *dest++ = c >> 16;
+        *dest++ = c >> 8;
+        *dest++ = c;
+      }
+    } else {
+      for(auto x = 0; x < graphics.bounds.w; x++) {
+        RGB888 c = src[x];
+        *dest++ = c;
+        *dest++ = c >> 8;
+        *dest++ = c >> 16;
+      }
+      // rows are padded to a whole number of words
+      while(dest < encoded.get() + encoded_length) *dest++ = 0;
+    }
+  }
+
+  Screenshot::Result Screenshot::begin(const char *filename, Format format) {
+    abort();
+    this->format = format;
+    row = 0;
+    write_failed = false;
+
+    uint32_t width = graphics.bounds.w;
+    encoded_length = format == FORMAT_PNG ? 1 + width * 3 : (width * 3 + 3) & ~3;
+
+    pixels.reset(new (std::nothrow) RGB888[width]);
+    encoded.reset(new (std::nothrow) uint8_t[encoded_length]);
+    if(!buffer) buffer.reset(new (std::nothrow) uint8_t[buffer_size]);
+    if(!pixels || !encoded || !buffer) return SCREENSHOT_NO_MEMORY;
+
+    // find out whether the pen can be read back before creating the file
+    if(!graphics.get_data(PicoGraphics::PEN_RGB888, 0, pixels.get())) return SCREENSHOT_UNSUPPORTED;
+
+    if(f_open(&file, filename, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) return SCREENSHOT_FILE_ERROR;
+    file_open = true;
+
+    if(format == FORMAT_PNG) {
+      write_png_header();
+    } else {
+      write_bmp_header();
+    }
+    return SCREENSHOT_OK;
+  }
+
+  Screenshot::Result Screenshot::capture_row() {
+    if(!file_open) return SCREENSHOT_NOT_STARTED;
+
+    uint64_t start = time_us_64();
+
+    graphics.get_data(PicoGraphics::PEN_RGB888, row, pixels.get());
+    encode_row();
+    if(format == FORMAT_PNG) {
+      put_image_data(encoded.get(), encoded_length);
+    } else {
+      put(encoded.get(), encoded_length);
+    }
+    row++;
+
+    Result result = SCREENSHOT_OK;
+    if(row == uint32_t(graphics.bounds.h)) {
+      result = finish();
+    } else if(write_failed) {
+      abort();
+      result = SCREENSHOT_FILE_ERROR;
+    }
+
+    uint32_t elapsed = time_us_64() - start;
+    stats.rows++;
+    stats.time_us += elapsed;
+    stats.max_row_us = std::max(stats.max_row_us, elapsed);
+    return result;
+  }
+
+  Screenshot::Result Screenshot::finish() {
+    if(format == FORMAT_PNG) write_png_trailer();
+    flush();
+    if(f_close(&file) != FR_OK) write_failed = true;
+    file_open = false;
+    return write_failed ? SCREENSHOT_FILE_ERROR : SCREENSHOT_DONE;
+  }
+
+  void Screenshot::abort() {
+    if(file_open) {
+      f_close(&file);
+      file_open = false;
+    }
+    buffered = 0;
+  }
+
+  Screenshot::Result Screenshot::save(const char *filename, Format format) {
+    Result result = begin(filename, format);
+    while(result == SCREENSHOT_OK) {
+      result = capture_row();
+    }
+    return result == SCREENSHOT_DONE ? SCREENSHOT_OK : result;
+  }
+
+}
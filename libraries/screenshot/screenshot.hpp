@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "pico/stdlib.h"
+#include "drivers/fatfs/ff.h"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+// Screenshots to FatFS
+//
+// Saves what PicoGraphics has drawn as a 24-bit BMP or PNG. Rows are read
+// back one at a time with PicoGraphics::get_data(), so any pen that
+// supports it works, including the compositor, and only a row of pixels is
+// held in RAM. Encoded rows collect in a write buffer that's written out in
+// whole, sector aligned blocks.
+//
+// PNGs use stored (uncompressed) deflate blocks, so there's no compression
+// to pay for and the file size is known before the first row is written.
+//
+// A capture can be spread out over the render loop, one row per call to
+// capture_row() after each update, so the loop never stalls for more than
+// a row and one buffer write. Anything drawn meanwhile shows up in the rows
+// not yet captured, so use save() if the image must be a single frame.
+//
+//   Screenshot screenshot(graphics);
+//   screenshot.begin("shot.png", Screenshot::FORMAT_PNG);
+//   while(true) {
+//     draw();
+//     display.update(&graphics);
+//     if(screenshot.capturing()) screenshot.capture_row();
+//   }
+namespace pimoroni {
+
+  class Screenshot {
+  public:
+    enum Format : uint8_t {
+      FORMAT_BMP,
+      FORMAT_PNG,
+    };
+
+    enum Result : int8_t {
+      SCREENSHOT_OK = 0,
+      SCREENSHOT_DONE,          // last row written and the file closed
+      SCREENSHOT_FILE_ERROR,    // couldn't create or write the file
+      SCREENSHOT_UNSUPPORTED,   // this pen can't be read back
+      SCREENSHOT_NO_MEMORY,
+      SCREENSHOT_NOT_STARTED,   // capture_row() without begin()
+    };
+
+    struct stats_t {
+      uint32_t rows;
+      uint32_t bytes;           // written to the file
+      uint64_t time_us;         // spent in capture_row()
+      uint32_t max_row_us;      // longest single capture_row()
+    };
+
+    // a whole number of sectors
+    static const uint32_t DEFAULT_BUFFER_SIZE = 4096;
+
+  private:
+    PicoGraphics &graphics;
+
+    FIL file;
+    bool file_open = false;
+    Format format = FORMAT_BMP;
+    uint32_t row = 0;
+
+    std::unique_ptr<RGB888[]> pixels;   // one row from get_data()
+    std::unique_ptr<uint8_t[]> encoded; // that row as it's stored in the file
+    uint32_t encoded_length = 0;
+
+    std::unique_ptr<uint8_t[]> buffer;
+    uint32_t buffer_size;
+    uint32_t buffered = 0;
+    bool write_failed = false;
+
+    // PNG image data, checksummed as it's written
+    uint32_t crc = 0;
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+    uint32_t block_remaining = 0;   // in the current stored block
+    uint32_t data_remaining = 0;    // uncompressed bytes still to come
+
+    stats_t stats = {};
+
+    void put(const void *data, uint32_t length);
+    void put_checked(const void *data, uint32_t length);
+    void put_image_data(const uint8_t *data, uint32_t length);
+    bool flush();
+
+    void write_bmp_header();
+    void write_png_header();
+    void write_png_trailer();
+    void encode_row();
+    Result finish();
+
+  public:
+    Screenshot(PicoGraphics &graphics, uint32_t buffer_size = DEFAULT_BUFFER_SIZE)
+      : graphics(graphics), buffer_size(buffer_size) {}
+    ~Screenshot() {abort();}
+
+    // create the file and write its header, ready for capture_row()
+    Result begin(const char *filename, Format format);
+    // capture the next row, returning SCREENSHOT_DONE once the image is complete
+    Result capture_row();
+    bool capturing() const {return file_open;}
+    // close the file early, leaving it incomplete
+    void abort();
+
+    // the whole image in one go
+    Result save(const char *filename, Format format);
+
+    const stats_t &get_stats() const {return stats;}
+    void reset_stats() {stats = {};}
+  };
+
+}
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+
+# wraps raw big-endian RGB565 frames in the header pimoroni::VideoPlayer
+# expects, e.g. straight from ffmpeg:
+#
+#   ffmpeg -i clip.mp4 -vf scale=320:240 -r 30 -f rawvideo -pix_fmt rgb565be clip.raw
+#   ./rgb565_video.py clip.raw clip.r565 --width 320 --height 240 --fps 30
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"R565"
+HEADER_SIZE = 512
+
+parser = argparse.ArgumentParser(description="Packs raw RGB565 frames for VideoPlayer.")
+parser.add_argument("input", help="raw rgb565be frames")
+parser.add_argument("output", help="output file")
+parser.add_argument("--width", type=int, required=True)
+parser.add_argument("--height", type=int, required=True)
+parser.add_argument("--fps", type=float, default=30)
+
+options = parser.parse_args()
+
+frame_size = options.width * options.height * 2
+
+with open(options.input, "rb") as f:
+    data = f.read()
+
+if len(data) % frame_size:
+    sys.exit(f"{options.input} isn't a whole number of {options.width}x{options.height} frames")
+
+frames = len(data) // frame_size
+header = MAGIC + struct.pack("<HHII", options.width, options.height, round(1000000 / options.fps), frames)
+
+with open(options.output, "wb") as f:
+    f.write(header.ljust(HEADER_SIZE, b"\0"))
+    f.write(data)
+
+print(f"{frames} frames, {len(data) + HEADER_SIZE} bytes")
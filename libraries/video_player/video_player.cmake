@@ -0,0 +1,11 @@
+if(NOT TARGET jpegdec)
+    include(${CMAKE_CURRENT_LIST_DIR}/../jpegdec/jpegdec.cmake)
+endif()
+
+add_library(video_player
+    ${CMAKE_CURRENT_LIST_DIR}/video_player.cpp
+)
+
+target_include_directories(video_player INTERFACE ${CMAKE_CURRENT_LIST_DIR})
+
+target_link_libraries(video_player jpegdec st7789 fatfs pico_graphics pico_stdlib hardware_dma)
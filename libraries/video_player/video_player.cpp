@@ -0,0 +1,519 @@
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+#include "pico/stdlib.h"
+
+#include "video_player.hpp"
+
+namespace pimoroni {
+
+  static inline uint16_t read_le16(const uint8_t *p) {
+    return p[0] | (p[1] << 8);
+  }
+
+  static inline uint32_t read_le32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+  }
+
+  // Length of the JPEG at the start of data, 0 if it isn't all there yet or
+  // -1 if it's broken. Marker segments are skipped by their length so an EOI
+  // in an embedded thumbnail doesn't end the frame early.
+  static int32_t jpeg_length(const uint8_t *data, uint32_t length) {
+    uint32_t i = 2;
+    bool entropy = false;
+
+    while(i + 1 < length) {
+      if(entropy) {
+        // stuffed zeros, fill bytes and restart markers are part of the scan
+        uint8_t m = data[i + 1];
+        if(data[i] != 0xff) {
+          i++;
+          continue;
+        }
+        if(m == 0x00 || (m >= 0xd0 && m <= 0xd7)) {
+          i += 2;
+          continue;
+        }
+        if(m == 0xff) {
+          i++;
+          continue;
+        }
+        entropy = false;
+      }
+
+      if(data[i] != 0xff) return -1;
+
+      uint8_t marker = data[i + 1];
+      if(marker == 0xff) {
+        i++;
+        continue;
+      }
+      if(marker == 0xd9) return i + 2;
+      if(marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7)) {
+        i += 2;
+        continue;
+      }
+
+      if(i + 3 >= length) return 0;
+      i += 2 + ((data[i + 2] << 8) | data[i + 3]);
+      if(marker == 0xda) entropy = true;
+    }
+
+    return 0;
+  }
+
+  bool VideoPlayer::fill(uint32_t length) {
+    if(available() >= length) return true;
+    if(length > buffer_size) return false;
+
+    // move what's left to the front, file_position stays on a sector
+    // boundary so FatFS can read whole sectors straight into the buffer
+    if(buffer_start) {
+      memmove(buffer.get(), buffer.get() + buffer_start, available());
+      buffer_end -= buffer_start;
+      buffer_start = 0;
+    }
+
+    while(available() < length && !eof) {
+      uint32_t space = (buffer_size - buffer_end) & ~(SECTOR_SIZE - 1);
+      if(space < length - available()) space = buffer_size - buffer_end;
+
+      uint64_t t = time_us_64();
+      UINT n = 0;
+      FRESULT result = f_read(&file, buffer.get() + buffer_end, space, &n);
+      stats.io_us += time_us_64() - t;
+
+      if(result != FR_OK) {
+        read_failed = true;
+        return false;
+      }
+      if(n < space) eof = true;
+      buffer_end += n;
+      file_position += n;
+    }
+
+    return available() >= length;
+  }
+
+  bool VideoPlayer::consume(uint32_t length) {
+    if(length <= available()) {
+      buffer_start += length;
+      return true;
+    }
+    return seek(position() + length);
+  }
+
+  bool VideoPlayer::seek(uint32_t offset) {
+    // already in the buffer?
+    if(buffer && offset >= file_position - buffer_end && offset <= file_position) {
+      buffer_start = offset - (file_position - buffer_end);
+      return true;
+    }
+
+    // raw video is read straight into the strips and has no buffer
+    uint32_t aligned = buffer ? offset & ~(SECTOR_SIZE - 1) : offset;
+
+    buffer_start = 0;
+    buffer_end = 0;
+    eof = false;
+
+    uint64_t t = time_us_64();
+    FRESULT result = f_lseek(&file, aligned);
+    stats.io_us += time_us_64() - t;
+    if(result != FR_OK) {
+      read_failed = true;
+      return false;
+    }
+    file_position = aligned;
+
+    if(!fill(offset - aligned)) return false;
+    buffer_start = offset - aligned;
+    return true;
+  }
+
+  bool VideoPlayer::read_direct(uint8_t *dest, uint32_t length) {
+    uint32_t n = std::min(length, available());
+    if(n) {
+      memcpy(dest, buffer.get() + buffer_start, n);
+      buffer_start += n;
+      dest += n;
+      length -= n;
+      if(!length) return true;
+    }
+
+    uint64_t t = time_us_64();
+    UINT read = 0;
+    FRESULT result = f_read(&file, dest, length, &read);
+    stats.io_us += time_us_64() - t;
+    file_position += read;
+
+    if(result != FR_OK) read_failed = true;
+    return read == length;
+  }
+
+  VideoPlayer::Result VideoPlayer::read_avi_header() {
+    if(!fill(12)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_INVALID_FILE;
+    const uint8_t *c = buffer.get() + buffer_start;
+    if(memcmp(c, "RIFF", 4) != 0 || memcmp(c + 8, "AVI ", 4) != 0) return VIDEO_INVALID_FILE;
+    consume(12);
+
+    int stream = -1;
+    bool video = false;
+    uint32_t file_size = f_size(&file);
+
+    // walk the header lists until we get to the frames
+    while(true) {
+      if(!fill(12)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_INVALID_FILE;
+      c = buffer.get() + buffer_start;
+      uint32_t size = read_le32(c + 4);
+
+      // sizes come straight from the file, so check them before any arithmetic
+      if(memcmp(c, "LIST", 4) == 0) {
+        if(memcmp(c + 8, "movi", 4) == 0) {
+          if(size < 4) return VIDEO_INVALID_FILE;
+          consume(12);
+          data_start = position();
+          // a recording that was cut short claims more than the file holds
+          data_end = data_start + std::min(size - 4, file_size - data_start);
+          break;
+        }
+        if(memcmp(c + 8, "hdrl", 4) == 0 || memcmp(c + 8, "strl", 4) == 0) {
+          if(c[8] == 's') stream++;
+          consume(12);
+          continue;
+        }
+      } else if(memcmp(c, "avih", 4) == 0) {
+        if(!fill(8 + 40)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_INVALID_FILE;
+        c = buffer.get() + buffer_start + 8;
+        frame_us = read_le32(c) ? read_le32(c) : frame_us;
+        frame_count = read_le32(c + 16);
+        width = read_le32(c + 32);
+        height = read_le32(c + 36);
+      } else if(memcmp(c, "strh", 4) == 0) {
+        if(memcmp(c + 8, "vids", 4) == 0 && !video && stream >= 0 && stream < 100) {
+          video = true;
+          stream_id[0] = '0' + stream / 10;
+          stream_id[1] = '0' + stream % 10;
+        }
+      }
+
+      if(size > file_size - position() - 8) return VIDEO_INVALID_FILE;
+      if(!consume(8 + size + (size & 1))) return read_failed ? VIDEO_FILE_ERROR : VIDEO_INVALID_FILE;
+    }
+
+    if(!video || width <= 0 || height <= 0) return VIDEO_INVALID_FILE;
+    return VIDEO_OK;
+  }
+
+  VideoPlayer::Result VideoPlayer::read_rgb565_header() {
+    if(!fill(16)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_INVALID_FILE;
+    const uint8_t *c = buffer.get() + buffer_start;
+
+    width = read_le16(c + 4);
+    height = read_le16(c + 6);
+    frame_us = read_le32(c + 8) ? read_le32(c + 8) : frame_us;
+    frame_count = read_le32(c + 12);
+    data_start = RGB565_HEADER_SIZE;
+
+    // raw frames are sent as they are, so have to fit
+    if(width == 0 || height == 0 || width > display.width || height > display.height) return VIDEO_INVALID_FILE;
+
+    source = Rect(0, 0, width, height);
+    return VIDEO_OK;
+  }
+
+  VideoPlayer::Result VideoPlayer::next_avi_frame(const uint8_t *&data, uint32_t &length, bool skip) {
+    while(true) {
+      if(position() + 8 > data_end) return VIDEO_END;
+      if(!fill(8)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+
+      const uint8_t *c = buffer.get() + buffer_start;
+      uint32_t size = read_le32(c + 4);
+
+      // frames can be grouped into 'rec ' lists
+      if(memcmp(c, "LIST", 4) == 0) {
+        if(!consume(12)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+        continue;
+      }
+
+      // a chunk running past the end of the movi list is corrupt, and its
+      // size would wrap the arithmetic below
+      if(size > data_end - position() - 8) return VIDEO_INVALID_FILE;
+
+      if(c[0] == stream_id[0] && c[1] == stream_id[1] && c[2] == 'd' && (c[3] == 'c' || c[3] == 'b')) {
+        pending = 8 + size + (size & 1);
+        length = size;
+        data = nullptr;
+        if(skip || size == 0) return VIDEO_OK;
+
+        if(size > buffer_size - 8) return VIDEO_FRAME_TOO_LARGE;
+        if(!fill(8 + size)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+        data = buffer.get() + buffer_start + 8;
+        return VIDEO_OK;
+      }
+
+      // audio, index and anything else
+      if(!consume(8 + size + (size & 1))) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+    }
+  }
+
+  VideoPlayer::Result VideoPlayer::next_mjpeg_frame(const uint8_t *&data, uint32_t &length) {
+    // skip anything between frames
+    while(true) {
+      if(!fill(2)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+      const uint8_t *c = buffer.get() + buffer_start;
+      if(c[0] == 0xff && c[1] == 0xd8) break;
+      consume(1);
+    }
+
+    while(true) {
+      int32_t n = jpeg_length(buffer.get() + buffer_start, available());
+      if(n < 0) return VIDEO_INVALID_FILE;
+      if(n > 0) {
+        data = buffer.get() + buffer_start;
+        length = n;
+        pending = n;
+        return VIDEO_OK;
+      }
+      if(available() == buffer_size) return VIDEO_FRAME_TOO_LARGE;
+      if(!fill(available() + 1)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+    }
+  }
+
+  void VideoPlayer::wait_for_bus() {
+    if(!display.write_busy()) return;
+    uint64_t t = time_us_64();
+    while(display.write_busy()) {}
+    stats.bus_us += time_us_64() - t;
+  }
+
+  void VideoPlayer::begin_frame(const Rect &window) {
+    wait_for_bus();
+    if(writing) display.write_end();
+    display.write_begin(window);
+    writing = true;
+  }
+
+  void VideoPlayer::send_strip(uint32_t rows) {
+    wait_for_bus();
+    display.write_async(strips.get() + strip * strip_pixels, rows * source.w * sizeof(uint16_t));
+    strip ^= 1;
+  }
+
+  int VideoPlayer::draw_block(JPEGDRAW *draw) {
+    Rect block = Rect(draw->x, draw->y, draw->iWidthUsed, draw->iHeight).intersection(source);
+    if(block.empty()) return 1;
+
+    uint16_t *dest = strips.get() + strip * strip_pixels + (block.x - source.x);
+    const uint16_t *src = draw->pPixels + (block.y - draw->y) * draw->iWidth + (block.x - draw->x);
+    for(auto y = 0; y < block.h; y++) {
+      memcpy(dest, src, block.w * sizeof(uint16_t));
+      dest += source.w;
+      src += draw->iWidth;
+    }
+
+    // the block on the right edge finishes the strip
+    if(block.x + block.w == source.x + source.w) send_strip(block.h);
+    return 1;
+  }
+
+  int VideoPlayer::draw(JPEGDRAW *draw) {
+    return ((VideoPlayer *)draw->pUser)->draw_block(draw);
+  }
+
+  VideoPlayer::Result VideoPlayer::show_jpeg(const uint8_t *data, uint32_t length) {
+    JPEGDEC &j = *jpeg;
+    if(!j.openRAM((uint8_t *)data, length, draw)) return VIDEO_DECODE_ERROR;
+    j.setUserPointer(this);
+    j.setPixelType(RGB565_BIG_ENDIAN);
+
+    int32_t w = j.getWidth();
+    int32_t h = j.getHeight();
+    if(!width) {
+      width = w;
+      height = h;
+    }
+
+    // scale down video that's at least twice the size of the display
+    int shift = 0;
+    while(shift < 2 && (w >> (shift + 1)) >= display.width && (h >> (shift + 1)) >= display.height) shift++;
+    w >>= shift;
+    h >>= shift;
+
+    // centre it, cropping whatever doesn't fit
+    source = Rect(std::max<int32_t>(0, (w - display.width) / 2), std::max<int32_t>(0, (h - display.height) / 2),
+                  std::min(w, int32_t(display.width)), std::min(h, int32_t(display.height)));
+    Rect window((display.width - source.w) / 2, (display.height - source.h) / 2, source.w, source.h);
+    if(source.w != w || source.h != h) j.setCropArea(source.x, source.y, source.w, source.h);
+
+    begin_frame(window);
+
+    uint64_t t = time_us_64();
+    uint64_t bus = stats.bus_us;
+    int result = j.decode(0, 0, shift == 1 ? JPEG_SCALE_HALF : shift == 2 ? JPEG_SCALE_QUARTER : 0);
+    j.close();
+    stats.decode_us += time_us_64() - t - (stats.bus_us - bus);
+
+    return result ? VIDEO_OK : VIDEO_DECODE_ERROR;
+  }
+
+  VideoPlayer::Result VideoPlayer::show_rgb565() {
+    begin_frame(Rect((display.width - width) / 2, (display.height - height) / 2, width, height));
+
+    // read each strip while the last one goes out
+    for(auto y = 0; y < height; y += STRIP_ROWS) {
+      uint32_t rows = std::min(int32_t(STRIP_ROWS), height - y);
+      if(!read_direct((uint8_t *)(strips.get() + strip * strip_pixels), rows * width * sizeof(uint16_t))) {
+        return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+      }
+      send_strip(rows);
+    }
+
+    return VIDEO_OK;
+  }
+
+  VideoPlayer::Result VideoPlayer::open(const char *filename, uint32_t frame_us) {
+    close();
+
+    this->frame_us = frame_us;
+    width = 0;
+    height = 0;
+    frame_count = 0;
+    buffer_start = 0;
+    buffer_end = 0;
+    file_position = 0;
+    pending = 0;
+    eof = false;
+    read_failed = false;
+    due = 0;
+
+    if(f_open(&file, filename, FA_READ) != FR_OK) return VIDEO_FILE_ERROR;
+    file_open = true;
+
+    strip_pixels = display.width * STRIP_ROWS;
+    buffer.reset(new (std::nothrow) uint8_t[buffer_size]);
+    strips.reset(new (std::nothrow) uint16_t[strip_pixels * 2]);
+    if(!buffer || !strips) {
+      close();
+      return VIDEO_NO_MEMORY;
+    }
+
+    Result result = VIDEO_INVALID_FILE;
+    if(fill(4)) {
+      const uint8_t *c = buffer.get();
+      if(memcmp(c, "RIFF", 4) == 0) {
+        format = FORMAT_AVI;
+        result = read_avi_header();
+      } else if(c[0] == 0xff && c[1] == 0xd8) {
+        format = FORMAT_MJPEG;
+        data_start = 0;
+        result = VIDEO_OK;
+      } else if(memcmp(c, "R565", 4) == 0) {
+        format = FORMAT_RGB565;
+        result = read_rgb565_header();
+      }
+    } else if(read_failed) {
+      result = VIDEO_FILE_ERROR;
+    }
+
+    if(result == VIDEO_OK && format != FORMAT_RGB565) {
+      jpeg.reset(new (std::nothrow) JPEGDEC);
+      if(!jpeg) result = VIDEO_NO_MEMORY;
+    }
+
+    // raw frames go straight from the file to the strips
+    if(result == VIDEO_OK && format == FORMAT_RGB565) buffer.reset();
+
+    if(result == VIDEO_OK && !seek(data_start)) result = read_failed ? VIDEO_FILE_ERROR : VIDEO_INVALID_FILE;
+
+    if(result != VIDEO_OK) close();
+    return result;
+  }
+
+  void VideoPlayer::close() {
+    if(writing) {
+      display.write_end();
+      writing = false;
+    }
+    if(file_open) {
+      f_close(&file);
+      file_open = false;
+    }
+    format = FORMAT_UNKNOWN;
+    buffer.reset();
+    strips.reset();
+    jpeg.reset();
+  }
+
+  bool VideoPlayer::rewind() {
+    if(!file_open) return false;
+    pending = 0;
+    due = 0;
+    return seek(data_start);
+  }
+
+  VideoPlayer::Result VideoPlayer::play_frame() {
+    if(!file_open) return VIDEO_FILE_ERROR;
+
+    while(true) {
+      // done with the last frame's data
+      if(pending) {
+        uint32_t n = pending;
+        pending = 0;
+        if(!consume(n)) return read_failed ? VIDEO_FILE_ERROR : VIDEO_END;
+      }
+
+      uint64_t now = time_us_64();
+      if(!started) started = now;
+      if(!due) due = now;
+
+      // more than a frame behind, skip this one
+      bool skip = paced && now >= due + frame_us;
+
+      const uint8_t *data = nullptr;
+      uint32_t length = 0;
+      Result result = VIDEO_OK;
+
+      switch(format) {
+        case FORMAT_AVI:
+          result = next_avi_frame(data, length, skip);
+          break;
+        case FORMAT_MJPEG:
+          result = next_mjpeg_frame(data, length);
+          break;
+        case FORMAT_RGB565:
+          if(skip) pending = width * height * sizeof(uint16_t);
+          break;
+        default:
+          return VIDEO_INVALID_FILE;
+      }
+      if(result != VIDEO_OK) return result;
+
+      if(skip) {
+        stats.dropped++;
+        due += frame_us;
+        continue;
+      }
+
+      now = time_us_64();
+      if(paced && now < due) {
+        sleep_us(due - now);
+        stats.idle_us += due - now;
+      }
+      due += frame_us;
+
+      // an empty AVI chunk repeats the last frame
+      if(format == FORMAT_RGB565) {
+        result = show_rgb565();
+      } else if(data) {
+        result = show_jpeg(data, length);
+      }
+
+      stats.frames++;
+      stats.elapsed_us = time_us_64() - started;
+      return result;
+    }
+  }
+
+}
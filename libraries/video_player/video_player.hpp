@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "drivers/fatfs/ff.h"
+#include "drivers/st7789/st7789.hpp"
+#include "libraries/jpegdec/JPEGDEC.h"
+
+// Video playback from FatFS straight to an ST7789 LCD
+//
+// Plays Motion-JPEG, either in an AVI container or as a plain run of
+// concatenated JPEGs, and a raw RGB565 format (see README.md). There's no
+// framebuffer: frames are decoded or read a band of rows at a time into one
+// of two strip buffers while the other is DMAed to the display.
+//
+// The file is read through a read-ahead buffer in whole sectors so FatFS
+// can transfer straight from the card, and a whole compressed frame is in
+// RAM before it's decoded. The buffer has to hold the largest frame in the
+// file, DEFAULT_BUFFER_SIZE is plenty for 320x240 at a sensible quality.
+//
+// Frames bigger than the display are centred and cropped (or decoded at
+// half/quarter scale if they're at least twice the size), smaller ones are
+// centred. When playback falls more than a frame behind, compressed frames
+// are skipped to catch up.
+//
+//   VideoPlayer player(st7789);
+//   if(player.open("clip.avi") == VideoPlayer::VIDEO_OK) {
+//     while(player.play_frame() == VideoPlayer::VIDEO_OK) {}
+//     player.close();
+//     printf("%.1f fps\n", player.get_stats().fps());
+//   }
+namespace pimoroni {
+
+  class VideoPlayer {
+  public:
+    enum Format : uint8_t {
+      FORMAT_UNKNOWN = 0,
+      FORMAT_AVI,       // RIFF AVI with an MJPG video stream
+      FORMAT_MJPEG,     // JPEG frames back to back
+      FORMAT_RGB565,    // raw big-endian RGB565 frames
+    };
+
+    enum Result : int8_t {
+      VIDEO_OK = 0,
+      VIDEO_END,              // no more frames, rewind() to loop
+      VIDEO_FILE_ERROR,       // couldn't open or read the file
+      VIDEO_INVALID_FILE,     // not a format we know, or a broken one
+      VIDEO_FRAME_TOO_LARGE,  // compressed frame won't fit in the buffer
+      VIDEO_DECODE_ERROR,
+      VIDEO_NO_MEMORY,
+    };
+
+    // Where the time went. Decoding, reading and the bus overlap, so the
+    // biggest of decode_us, io_us and bus_us is what limits the frame rate.
+    struct stats_t {
+      uint32_t frames;
+      uint32_t dropped;     // skipped to catch up after falling behind
+      uint64_t elapsed_us;
+      uint64_t io_us;       // reading the file
+      uint64_t decode_us;   // decoding frames into the strip buffers
+      uint64_t bus_us;      // waiting for the display to take the last strip
+      uint64_t idle_us;     // ahead of time, waiting to show the next frame
+
+      float fps() const {
+        return elapsed_us ? frames * 1000000.0f / elapsed_us : 0.0f;
+      }
+    };
+
+    static const uint32_t DEFAULT_BUFFER_SIZE = 48 * 1024;
+    static const uint32_t SECTOR_SIZE = 512;
+    static const uint32_t STRIP_ROWS = 16;
+    static const uint32_t DEFAULT_FRAME_US = 33333;
+
+    // raw RGB565 files start with a header padded out to a whole sector
+    static const uint32_t RGB565_HEADER_SIZE = SECTOR_SIZE;
+
+  private:
+    ST7789 &display;
+
+    FIL file;
+    bool file_open = false;
+    Format format = FORMAT_UNKNOWN;
+
+    int32_t width = 0;          // of the video, 0 for MJPEG until a frame is read
+    int32_t height = 0;
+    uint32_t frame_us = DEFAULT_FRAME_US;
+    uint32_t frame_count = 0;   // 0 if not known
+    uint32_t data_start = 0;    // offset of the first frame
+    uint32_t data_end = 0;      // end of the AVI movi list
+    char stream_id[2] = {'0', '0'};
+
+    // read-ahead, bytes [start, end) of buffer come from file_position - (end - start)
+    std::unique_ptr<uint8_t[]> buffer;
+    uint32_t buffer_size;
+    uint32_t buffer_start = 0;
+    uint32_t buffer_end = 0;
+    uint32_t file_position = 0;
+    uint32_t pending = 0;       // bytes of the current frame still to consume
+    bool eof = false;
+    bool read_failed = false;
+
+    // strip buffers, one filling while the other goes out to the display
+    std::unique_ptr<uint16_t[]> strips;
+    uint32_t strip_pixels = 0;
+    uint8_t strip = 0;
+    bool writing = false;
+
+    std::unique_ptr<JPEGDEC> jpeg;
+    Rect source;                // part of the decoded image that's shown
+
+    bool paced = true;
+    uint64_t started = 0;
+    uint64_t due = 0;
+    stats_t stats = {};
+
+    uint32_t available() const {return buffer_end - buffer_start;}
+    uint32_t position() const {return file_position - available();}
+    bool fill(uint32_t length);
+    bool consume(uint32_t length);
+    bool seek(uint32_t offset);
+    bool read_direct(uint8_t *dest, uint32_t length);
+
+    Result read_avi_header();
+    Result read_rgb565_header();
+    Result next_avi_frame(const uint8_t *&data, uint32_t &length, bool skip);
+    Result next_mjpeg_frame(const uint8_t *&data, uint32_t &length);
+
+    void wait_for_bus();
+    void begin_frame(const Rect &window);
+    void send_strip(uint32_t rows);
+    Result show_jpeg(const uint8_t *data, uint32_t length);
+    Result show_rgb565();
+    int draw_block(JPEGDRAW *draw);
+    static int draw(JPEGDRAW *draw);
+
+  public:
+    VideoPlayer(ST7789 &display, uint32_t buffer_size = DEFAULT_BUFFER_SIZE)
+      : display(display), buffer_size(buffer_size) {}
+    ~VideoPlayer() {close();}
+
+    // frame_us is used for files that don't say, i.e. plain MJPEG
+    Result open(const char *filename, uint32_t frame_us = DEFAULT_FRAME_US);
+    void close();
+
+    // read, decode and show the next frame, waiting until it's due
+    Result play_frame();
+    // back to the first frame, pacing starts again from the next one shown
+    bool rewind();
+
+    // play as fast as the card, decoder and display allow, e.g. for testing
+    void set_paced(bool paced) {this->paced = paced;}
+
+    Format get_format() const {return format;}
+    int32_t get_width() const {return width;}
+    int32_t get_height() const {return height;}
+    uint32_t get_frame_us() const {return frame_us;}
+    uint32_t get_frame_count() const {return frame_count;}
+
+    const stats_t &get_stats() const {return stats;}
+    void reset_stats() {stats = {}; started = 0;}
+  };
+
+}
@@ -342,6 +342,7 @@ mp_obj_t Channel_play_tone(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw
 typedef struct _CosmicUnicorn_obj_t {
     mp_obj_base_t base;
     CosmicUnicorn* Cosmic;
+    void *back_buf;
 } _CosmicUnicorn_obj_t;
 
 typedef struct _ModPicoGraphics_obj_t {
@@ -366,10 +367,11 @@ void CosmicUnicorn_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kin
 mp_obj_t CosmicUnicorn_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
     _CosmicUnicorn_obj_t *self = nullptr;
 
-    enum { ARG_pio, ARG_sm, ARG_pins, ARG_common_pin, ARG_direction, ARG_counts_per_rev, ARG_count_microsteps, ARG_freq_divider };
+    enum { ARG_pio, ARG_sm, ARG_double_buffer };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_pio, MP_ARG_INT },
-        { MP_QSTR_sm, MP_ARG_INT }
+        { MP_QSTR_sm, MP_ARG_INT },
+        { MP_QSTR_double_buffer, MP_ARG_BOOL, {.u_bool = false} }
     };
 
     // Parse args.
@@ -394,6 +396,12 @@ mp_obj_t CosmicUnicorn_make_new(const mp_obj_type_t *type, size_t n_args, size_t
     self = m_new_obj_with_finaliser(_CosmicUnicorn_obj_t);
     self->base.type = &CosmicUnicorn_type;
     self->Cosmic = Cosmic;
+    self->back_buf = nullptr;
+
+    if(args[ARG_double_buffer].u_bool) {
+        self->back_buf = m_new(uint8_t, CosmicUnicorn::bitstream_length());
+        Cosmic->set_double_buffered((uint8_t *)self->back_buf);
+    }
 
     return MP_OBJ_FROM_PTR(self);
 }
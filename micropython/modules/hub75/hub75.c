@@ -8,6 +8,10 @@ MP_DEFINE_CONST_FUN_OBJ_1(Hub75_clear_obj, Hub75_clear);
 MP_DEFINE_CONST_FUN_OBJ_1(Hub75_start_obj, Hub75_start);
 MP_DEFINE_CONST_FUN_OBJ_1(Hub75_stop_obj, Hub75_stop);
 MP_DEFINE_CONST_FUN_OBJ_2(Hub75_update_obj, Hub75_update);
+MP_DEFINE_CONST_FUN_OBJ_1(Hub75_swap_buffers_obj, Hub75_swap_buffers);
+MP_DEFINE_CONST_FUN_OBJ_1(Hub75_wait_for_swap_obj, Hub75_wait_for_swap);
+MP_DEFINE_CONST_FUN_OBJ_1(Hub75_refresh_rate_obj, Hub75_refresh_rate);
+MP_DEFINE_CONST_FUN_OBJ_KW(Hub75_set_layout_obj, 5, Hub75_set_layout);
 
 
 /***** Binding of Methods *****/
@@ -18,6 +22,10 @@ STATIC const mp_rom_map_elem_t Hub75_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&Hub75_start_obj) },
     { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&Hub75_stop_obj) },
     { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&Hub75_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_swap_buffers), MP_ROM_PTR(&Hub75_swap_buffers_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait_for_swap), MP_ROM_PTR(&Hub75_wait_for_swap_obj) },
+    { MP_ROM_QSTR(MP_QSTR_refresh_rate), MP_ROM_PTR(&Hub75_refresh_rate_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_layout), MP_ROM_PTR(&Hub75_set_layout_obj) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(Hub75_locals_dict, Hub75_locals_dict_table);
@@ -38,6 +38,7 @@ typedef struct _Hub75_obj_t {
     mp_obj_base_t base;
     Hub75* hub75;
     void *buf;
+    void *back_buf;
 } _Hub75_obj_t;
 
 _Hub75_obj_t *hub75_obj;
@@ -86,7 +87,10 @@ mp_obj_t Hub75_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, c
         ARG_buffer,
         ARG_panel_type,
         ARG_stb_invert,
-        ARG_color_order
+        ARG_color_order,
+        ARG_double_buffer,
+        ARG_bit_depth,
+        ARG_dither
     };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_width, MP_ARG_REQUIRED | MP_ARG_INT },
@@ -95,6 +99,9 @@ mp_obj_t Hub75_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, c
         { MP_QSTR_panel_type, MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_stb_invert, MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_color_order, MP_ARG_INT, {.u_int = (uint8_t)Hub75::COLOR_ORDER::RGB} },
+        { MP_QSTR_double_buffer, MP_ARG_BOOL, {.u_bool = false} },
+        { MP_QSTR_bit_depth, MP_ARG_INT, {.u_int = BIT_DEPTH} },
+        { MP_QSTR_dither, MP_ARG_BOOL, {.u_bool = false} },
     };
 
     // Parse args.
@@ -106,6 +113,11 @@ mp_obj_t Hub75_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, c
     PanelType paneltype = (PanelType)args[ARG_panel_type].u_int;
     bool stb_invert = args[ARG_stb_invert].u_int;
     Hub75::COLOR_ORDER color_order = (Hub75::COLOR_ORDER)args[ARG_color_order].u_int;
+    int bit_depth = args[ARG_bit_depth].u_int;
+
+    if(bit_depth < (int)MIN_BIT_DEPTH || bit_depth > (int)BIT_DEPTH) {
+        mp_raise_ValueError("bit_depth out of range. Expected 6 to 10");
+    }
 
     Pixel *buffer = nullptr;
 
@@ -123,8 +135,18 @@ mp_obj_t Hub75_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, c
     hub75_obj = m_new_obj_with_finaliser(_Hub75_obj_t);
     hub75_obj->base.type = &Hub75_type;
     hub75_obj->buf = buffer;
+    hub75_obj->back_buf = nullptr;
     hub75_obj->hub75 = m_new_class(Hub75, width, height, buffer, paneltype, stb_invert, color_order);
 
+    hub75_obj->hub75->set_bit_depth(bit_depth);
+    hub75_obj->hub75->dither = args[ARG_dither].u_bool;
+
+    // update() draws into the second buffer while the panel shows the first
+    if (args[ARG_double_buffer].u_bool) {
+        hub75_obj->back_buf = m_new(Pixel, width * height);
+        hub75_obj->hub75->set_double_buffered((Pixel *)hub75_obj->back_buf);
+    }
+
     return MP_OBJ_FROM_PTR(hub75_obj);
 }
 
@@ -155,6 +177,23 @@ mp_obj_t Hub75_stop(mp_obj_t self_in) {
     return mp_const_none;
 }
 
+mp_obj_t Hub75_swap_buffers(mp_obj_t self_in) {
+    _Hub75_obj_t *self = MP_OBJ_TO_PTR2(self_in, _Hub75_obj_t);
+    self->hub75->swap_buffers();
+    return mp_const_none;
+}
+
+mp_obj_t Hub75_wait_for_swap(mp_obj_t self_in) {
+    _Hub75_obj_t *self = MP_OBJ_TO_PTR2(self_in, _Hub75_obj_t);
+    self->hub75->wait_for_swap();
+    return mp_const_none;
+}
+
+mp_obj_t Hub75_refresh_rate(mp_obj_t self_in) {
+    _Hub75_obj_t *self = MP_OBJ_TO_PTR2(self_in, _Hub75_obj_t);
+    return mp_obj_new_float(self->hub75->get_refresh_rate());
+}
+
 mp_obj_t Hub75_set_pixel(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     enum { ARG_self, ARG_x, ARG_y, ARG_r, ARG_g, ARG_b };
     static const mp_arg_t allowed_args[] = {
@@ -182,4 +221,45 @@ mp_obj_t Hub75_set_pixel(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_a
     return mp_const_none;
 }
 
+mp_obj_t Hub75_set_layout(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_self, ARG_panel_width, ARG_panel_height, ARG_columns, ARG_rows, ARG_serpentine, ARG_scan_rows };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_panel_width, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_panel_height, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_columns, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_rows, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_serpentine, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
+        { MP_QSTR_scan_rows, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} }
+    };
+
+    // Parse args.
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    int panel_width = args[ARG_panel_width].u_int;
+    int panel_height = args[ARG_panel_height].u_int;
+    int columns = args[ARG_columns].u_int;
+    int rows = args[ARG_rows].u_int;
+    int scan_rows = args[ARG_scan_rows].u_int;
+
+    if(panel_width < 1 || panel_height < 2 || columns < 1 || rows < 1 || scan_rows < 0) {
+        mp_raise_ValueError("layout out of range");
+    }
+
+    _Hub75_obj_t *self = MP_OBJ_TO_PTR2(args[ARG_self].u_obj, _Hub75_obj_t);
+
+    // The refresh has to be rebuilt for the new layout
+    bool refreshing = self->hub75->refreshing;
+    if(refreshing) self->hub75->stop(dma_complete);
+    bool result = self->hub75->set_grid_layout(panel_width, panel_height, columns, rows, args[ARG_serpentine].u_bool, scan_rows);
+    if(refreshing) self->hub75->start(dma_complete);
+
+    if(!result) {
+        mp_raise_ValueError("layout does not match the display. Expected columns * panel_width by rows * panel_height");
+    }
+
+    return mp_const_none;
+}
+
 }
\ No newline at end of file
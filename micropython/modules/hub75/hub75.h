@@ -13,4 +13,8 @@ extern mp_obj_t Hub75_start(mp_obj_t self_in);
 extern mp_obj_t Hub75_stop(mp_obj_t self_in);
 extern mp_obj_t Hub75_set_pixel(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t Hub75_clear(mp_obj_t self_in);
-extern mp_obj_t Hub75_update(mp_obj_t self_in, mp_obj_t graphics_in);
\ No newline at end of file
+extern mp_obj_t Hub75_update(mp_obj_t self_in, mp_obj_t graphics_in);
+extern mp_obj_t Hub75_swap_buffers(mp_obj_t self_in);
+extern mp_obj_t Hub75_wait_for_swap(mp_obj_t self_in);
+extern mp_obj_t Hub75_refresh_rate(mp_obj_t self_in);
+extern mp_obj_t Hub75_set_layout(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
\ No newline at end of file
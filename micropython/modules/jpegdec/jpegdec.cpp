@@ -2,6 +2,7 @@
 
 #include "micropython/modules/util.hpp"
 #include "libraries/pico_graphics/pico_graphics.hpp"
+#include "libraries/jpegdec/jpeg_graphics.hpp"
 
 using namespace pimoroni;
 
@@ -29,13 +30,6 @@ typedef struct _JPEG_obj_t {
 } _JPEG_obj_t;
 
 
-uint8_t current_flags = 0;
-
-enum FLAGS : uint8_t {
-    FLAG_NO_DITHER = 1u
-};
-
-
 void *jpegdec_open_callback(const char *filename, int32_t *size) {
     mp_obj_t fn = mp_obj_new_str(filename, (mp_uint_t)strlen(filename));
 
@@ -87,86 +81,7 @@ int JPEGDraw(JPEGDRAW *pDraw) {
 #ifdef MICROPY_EVENT_POLL_HOOK
 MICROPY_EVENT_POLL_HOOK
 #endif
-    PicoGraphics *current_graphics = (PicoGraphics *)pDraw->pUser;
-    // "pixel" is slow and clipped,
-    // guaranteeing we wont draw jpeg data out of the framebuffer..
-    // Can we clip beforehand and make this faster?
-    if(pDraw->iBpp == 8) {
-        uint8_t *pixel = (uint8_t *)pDraw->pPixels;
-        for(int y = 0; y < pDraw->iHeight; y++) {
-            for(int x = 0; x < pDraw->iWidth; x++) {
-                if(x < pDraw->iWidthUsed) { // Clip to the used width
-                    current_graphics->set_pen((uint8_t)(*pixel >> 4));
-                    current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-                }
-                pixel++;
-            }
-        }
-    } else if(pDraw->iBpp == 4) {
-        uint8_t *pixels = (uint8_t *)pDraw->pPixels;
-        for(int y = 0; y < pDraw->iHeight; y++) {
-            for(int x = 0; x < pDraw->iWidth; x++) {
-                if(x >= pDraw->iWidthUsed) break; // Clip to the used width
-                int i = y * pDraw->iWidth + x;
-                uint8_t p = pixels[i / 2];
-                p >>= (i & 0b1) ? 0 : 4;
-                p &= 0xf;
-                current_graphics->set_pen(p);
-                current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-            }
-        }
-    } else if(pDraw->iBpp == 1) {
-        uint8_t *pixels = (uint8_t *)pDraw->pPixels;
-        for(int y = 0; y < pDraw->iHeight; y++) {
-            for(int x = 0; x < pDraw->iWidth; x++) {
-                if(x >= pDraw->iWidthUsed) break; // Clip to the used width
-                int i = y * pDraw->iWidth + x;
-                uint8_t p = pixels[i / 8];
-                p >>= 7 - (i & 0b111);
-                p &= 0x1;
-                current_graphics->set_pen(p);
-                current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-            }
-        }
-    } else {
-        for(int y = 0; y < pDraw->iHeight; y++) {
-            for(int x = 0; x < pDraw->iWidth; x++) {
-                if(x >= pDraw->iWidthUsed) break; // Clip to the used width
-                int i = y * pDraw->iWidth + x;
-                if (current_graphics->pen_type == PicoGraphics::PEN_RGB332) {
-                    if (current_flags & FLAG_NO_DITHER) {
-                        // Posterized output to RGB332
-                        current_graphics->set_pen(RGB((RGB565)pDraw->pPixels[i]).to_rgb332());
-                        current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-                    } else {
-                        // Dithered output to RGB332
-                        current_graphics->set_pixel_dither({pDraw->x + x, pDraw->y + y}, (RGB565)(pDraw->pPixels[i]));
-                    }
-                } else if (current_graphics->pen_type == PicoGraphics::PEN_RGB888) {
-                    current_graphics->set_pen(RGB((RGB565)pDraw->pPixels[i]).to_rgb888());
-                    current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-                } else if (current_graphics->pen_type == PicoGraphics::PEN_P8 
-                || current_graphics->pen_type == PicoGraphics::PEN_P4
-                || current_graphics->pen_type == PicoGraphics::PEN_3BIT
-                || current_graphics->pen_type == PicoGraphics::PEN_INKY7) {
-                    if (current_flags & FLAG_NO_DITHER) {
-                        int closest = RGB((RGB565)pDraw->pPixels[i]).closest(current_graphics->get_palette(), current_graphics->get_palette_size());
-                        if (closest == -1) {
-                            closest = 0;
-                        }
-                        current_graphics->set_pen(closest);
-                        current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-                    } else {
-                        current_graphics->set_pixel_dither({pDraw->x + x, pDraw->y + y}, RGB((RGB565)pDraw->pPixels[i]));
-                    }
-                } else {
-                    current_graphics->set_pen(pDraw->pPixels[i]);
-                    current_graphics->pixel({pDraw->x + x, pDraw->y + y});
-                } 
-            }
-        }
-    }
-    return 1;
+    return JPEGGraphics::draw(pDraw);
 }
 
 mp_obj_t _JPEG_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
@@ -219,13 +134,15 @@ mp_obj_t _JPEG_openRAM(mp_obj_t self_in, mp_obj_t buffer) {
 
 // decode
 mp_obj_t _JPEG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_self, ARG_x, ARG_y, ARG_scale, ARG_dither };
+    enum { ARG_self, ARG_x, ARG_y, ARG_scale, ARG_dither, ARG_w, ARG_h };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ },
         { MP_QSTR_x, MP_ARG_INT, {.u_int = 0}  },
         { MP_QSTR_y, MP_ARG_INT, {.u_int = 0}  },
         { MP_QSTR_scale, MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_dither, MP_ARG_OBJ, {.u_obj = mp_const_true} },
+        { MP_QSTR_w, MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_h, MP_ARG_INT, {.u_int = 0} },
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -236,8 +153,10 @@ mp_obj_t _JPEG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
     int x = args[ARG_x].u_int;
     int y = args[ARG_y].u_int;
     int f = args[ARG_scale].u_int;
+    int w = args[ARG_w].u_int;
+    int h = args[ARG_h].u_int;
 
-    current_flags = args[ARG_dither].u_obj == mp_const_false ? FLAG_NO_DITHER : 0;
+    JPEGGraphics target(self->graphics->graphics, args[ARG_dither].u_obj == mp_const_false ? JPEGGraphics::NO_DITHER : 0);
 
     // Just-in-time open of the filename/buffer we stored in self->file via open_RAM or open_file
 
@@ -266,31 +185,14 @@ mp_obj_t _JPEG_decode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args
     
     if(result != 1) mp_raise_msg(&mp_type_RuntimeError, "JPEG: could not read file/buffer.");
 
-    // Force a specific data output type to best match our PicoGraphics buffer
-    switch(self->graphics->graphics->pen_type) {
-        case PicoGraphics::PEN_RGB332:
-        case PicoGraphics::PEN_RGB565:
-        case PicoGraphics::PEN_RGB888:
-        case PicoGraphics::PEN_P8:
-        case PicoGraphics::PEN_P4:
-        case PicoGraphics::PEN_3BIT:
-        case PicoGraphics::PEN_INKY7:
-            self->jpeg->setPixelType(RGB565_BIG_ENDIAN);
-            break;
-        // TODO 2-bit is currently unsupported
-        case PicoGraphics::PEN_P2:
-        case PicoGraphics::PEN_1BIT:
-            self->jpeg->setPixelType(EIGHT_BIT_GRAYSCALE);
-            break;
+    // Decode only the MCUs that land inside the clip rect, scaling the image
+    // down to fit inside w x h if given
+    if(w > 0 && h > 0) {
+        result = target.decode_fit(*self->jpeg, Rect(x, y, w, h));
+    } else {
+        result = target.decode(*self->jpeg, Point(x, y), f);
     }
 
-    // We need to store a pointer to the PicoGraphics surface
-    self->jpeg->setUserPointer((void *)self->graphics->graphics);
-
-    result = self->jpeg->decode(x, y, f);
-
-    current_flags = 0;
-
     // Close the file since we've opened it on-demand
     self->jpeg->close();
 
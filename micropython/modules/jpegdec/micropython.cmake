@@ -4,6 +4,7 @@ target_sources(usermod_jpegdec INTERFACE
     ${CMAKE_CURRENT_LIST_DIR}/jpegdec.c
     ${CMAKE_CURRENT_LIST_DIR}/jpegdec.cpp
     ${CMAKE_CURRENT_LIST_DIR}/../../../libraries/jpegdec/JPEGDEC.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/../../../libraries/jpegdec/jpeg_graphics.cpp
 )
 
 target_include_directories(usermod_jpegdec INTERFACE
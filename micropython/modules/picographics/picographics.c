@@ -35,6 +35,7 @@ MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ModPicoGraphics_circle_obj, 4, 4, ModPicoGra
 MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_character_obj, 1, ModPicoGraphics_character);
 MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_text_obj, 1, ModPicoGraphics_text);
 MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_measure_text_obj, 1, ModPicoGraphics_measure_text);
+MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_layout_text_obj, 2, ModPicoGraphics_layout_text);
 MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_polygon_obj, 2, ModPicoGraphics_polygon);
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ModPicoGraphics_triangle_obj, 7, 7, ModPicoGraphics_triangle);
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ModPicoGraphics_line_obj, 5, 5, ModPicoGraphics_line);
@@ -44,6 +45,11 @@ MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_set_spritesheet_obj, ModPicoGraphics_s
 MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_load_spritesheet_obj, ModPicoGraphics_load_spritesheet);
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(ModPicoGraphics_sprite_obj, 5, 7, ModPicoGraphics_sprite);
 
+// Layers
+MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_add_layer_obj, 2, ModPicoGraphics_add_layer);
+MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_select_layer_obj, ModPicoGraphics_select_layer);
+MP_DEFINE_CONST_FUN_OBJ_KW(ModPicoGraphics_set_layer_obj, 2, ModPicoGraphics_set_layer);
+
 // Utility
 //MP_DEFINE_CONST_FUN_OBJ_2(ModPicoGraphics_set_scanline_callback_obj, ModPicoGraphics_set_scanline_callback);
 MP_DEFINE_CONST_FUN_OBJ_1(ModPicoGraphics_get_bounds_obj, ModPicoGraphics_get_bounds);
@@ -71,6 +77,7 @@ STATIC const mp_rom_map_elem_t ModPicoGraphics_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_character), MP_ROM_PTR(&ModPicoGraphics_character_obj) },
     { MP_ROM_QSTR(MP_QSTR_text), MP_ROM_PTR(&ModPicoGraphics_text_obj) },
     { MP_ROM_QSTR(MP_QSTR_measure_text), MP_ROM_PTR(&ModPicoGraphics_measure_text_obj) },
+    { MP_ROM_QSTR(MP_QSTR_layout_text), MP_ROM_PTR(&ModPicoGraphics_layout_text_obj) },
     { MP_ROM_QSTR(MP_QSTR_polygon), MP_ROM_PTR(&ModPicoGraphics_polygon_obj) },
     { MP_ROM_QSTR(MP_QSTR_triangle), MP_ROM_PTR(&ModPicoGraphics_triangle_obj) },
     { MP_ROM_QSTR(MP_QSTR_line), MP_ROM_PTR(&ModPicoGraphics_line_obj) },
@@ -87,6 +94,10 @@ STATIC const mp_rom_map_elem_t ModPicoGraphics_locals_dict_table[] = {
 
     { MP_ROM_QSTR(MP_QSTR_set_backlight), MP_ROM_PTR(&ModPicoGraphics_set_backlight_obj) },
 
+    { MP_ROM_QSTR(MP_QSTR_add_layer), MP_ROM_PTR(&ModPicoGraphics_add_layer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_select_layer), MP_ROM_PTR(&ModPicoGraphics_select_layer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set_layer), MP_ROM_PTR(&ModPicoGraphics_set_layer_obj) },
+
     //{ MP_ROM_QSTR(MP_QSTR_set_scanline_callback), MP_ROM_PTR(&ModPicoGraphics_set_scanline_callback_obj) },
     { MP_ROM_QSTR(MP_QSTR_get_bounds), MP_ROM_PTR(&ModPicoGraphics_get_bounds_obj) },
     { MP_ROM_QSTR(MP_QSTR_set_font), MP_ROM_PTR(&ModPicoGraphics_set_font_obj) },
@@ -116,6 +127,34 @@ const mp_obj_type_t ModPicoGraphics_type = {
 };
 #endif
 
+/***** Text Layout *****/
+MP_DEFINE_CONST_FUN_OBJ_1(ModPicoGraphics_TextLayout_get_bounds_obj, ModPicoGraphics_TextLayout_get_bounds);
+MP_DEFINE_CONST_FUN_OBJ_3(ModPicoGraphics_TextLayout_hit_test_obj, ModPicoGraphics_TextLayout_hit_test);
+MP_DEFINE_CONST_FUN_OBJ_1(ModPicoGraphics_TextLayout__del__obj, ModPicoGraphics_TextLayout__del__);
+
+STATIC const mp_rom_map_elem_t ModPicoGraphics_TextLayout_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_get_bounds), MP_ROM_PTR(&ModPicoGraphics_TextLayout_get_bounds_obj) },
+    { MP_ROM_QSTR(MP_QSTR_hit_test), MP_ROM_PTR(&ModPicoGraphics_TextLayout_hit_test_obj) },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&ModPicoGraphics_TextLayout__del__obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(ModPicoGraphics_TextLayout_locals_dict, ModPicoGraphics_TextLayout_locals_dict_table);
+
+// Made by PicoGraphics.layout_text(), so there's no make_new
+#ifdef MP_DEFINE_CONST_OBJ_TYPE
+MP_DEFINE_CONST_OBJ_TYPE(
+    ModPicoGraphics_TextLayout_type,
+    MP_QSTR_TextLayout,
+    MP_TYPE_FLAG_NONE,
+    locals_dict, (mp_obj_dict_t*)&ModPicoGraphics_TextLayout_locals_dict
+);
+#else
+const mp_obj_type_t ModPicoGraphics_TextLayout_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_TextLayout,
+    .locals_dict = (mp_obj_dict_t*)&ModPicoGraphics_TextLayout_locals_dict,
+};
+#endif
+
 /***** Module Globals *****/
 STATIC const mp_map_elem_t picographics_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR_picographics) },
@@ -159,6 +198,11 @@ STATIC const mp_map_elem_t picographics_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_PEN_RGB332), MP_ROM_INT(PEN_RGB332) },
     { MP_ROM_QSTR(MP_QSTR_PEN_RGB565), MP_ROM_INT(PEN_RGB565) },
     { MP_ROM_QSTR(MP_QSTR_PEN_RGB888), MP_ROM_INT(PEN_RGB888) },
+    { MP_ROM_QSTR(MP_QSTR_PEN_COMPOSITOR), MP_ROM_INT(PEN_COMPOSITOR) },
+
+    { MP_ROM_QSTR(MP_QSTR_ALIGN_LEFT), MP_ROM_INT(ALIGN_LEFT) },
+    { MP_ROM_QSTR(MP_QSTR_ALIGN_CENTER), MP_ROM_INT(ALIGN_CENTER) },
+    { MP_ROM_QSTR(MP_QSTR_ALIGN_RIGHT), MP_ROM_INT(ALIGN_RIGHT) },
 };
 STATIC MP_DEFINE_CONST_DICT(mp_module_picographics_globals, picographics_globals_table);
 
@@ -39,8 +39,18 @@ typedef struct _ModPicoGraphics_obj_t {
     void *buffer;
     _PimoroniI2C_obj_t *i2c;
     //mp_obj_t scanline_callback; // Not really feasible in MicroPython
+    // With PEN_COMPOSITOR, graphics is the layer being drawn to. The layers
+    // are also listed here so the GC can see them
+    PicoGraphics_Compositor *compositor;
+    PicoGraphics **layers;
+    size_t layer_count;
 } ModPicoGraphics_obj_t;
 
+typedef struct _ModPicoGraphics_TextLayout_obj_t {
+    mp_obj_base_t base;
+    TextLayout *layout;
+} ModPicoGraphics_TextLayout_obj_t;
+
 bool get_display_settings(PicoGraphicsDisplay display, int &width, int &height, int &rotate, int &pen_type, PicoGraphicsBusType &bus_type) {
     switch(display) {
         case DISPLAY_PICO_DISPLAY:
@@ -259,6 +269,9 @@ mp_obj_t ModPicoGraphics_make_new(const mp_obj_type_t *type, size_t n_args, size
 
     self = m_new_obj_with_finaliser(ModPicoGraphics_obj_t);
     self->base.type = &ModPicoGraphics_type;
+    self->compositor = nullptr;
+    self->layers = nullptr;
+    self->layer_count = 0;
 
     PicoGraphicsDisplay display = (PicoGraphicsDisplay)args[ARG_display].u_int;
 
@@ -348,11 +361,21 @@ mp_obj_t ModPicoGraphics_make_new(const mp_obj_type_t *type, size_t n_args, size
         self->display = m_new_class(ST7789, width, height, (Rotation)rotate, round, spi_bus);
     }
 
+    // Layers are composited as the display reads them, which only the LCDs do
+    bool lcd = display != DISPLAY_INKY_FRAME && display != DISPLAY_INKY_FRAME_4 && display != DISPLAY_INKY_FRAME_7
+            && display != DISPLAY_I2C_OLED_128X128 && display != DISPLAY_INKY_PACK && display != DISPLAY_GFX_PACK
+            && display != DISPLAY_GALACTIC_UNICORN && display != DISPLAY_COSMIC_UNICORN
+            && !(display >= DISPLAY_INTERSTATE75_32X32 && display <= DISPLAY_INTERSTATE75_256X64);
+    if(pen_type == PEN_COMPOSITOR && !lcd) mp_raise_ValueError("PEN_COMPOSITOR needs an LCD display!");
+
     // Create or fetch buffer
     size_t required_size = get_required_buffer_size((PicoGraphicsPenType)pen_type, width, height);
-    if(required_size == 0) mp_raise_ValueError("Unsupported pen type!");
+    if(required_size == 0 && pen_type != PEN_COMPOSITOR) mp_raise_ValueError("Unsupported pen type!");
 
-    if(pen_type == PEN_INKY7) {
+    if(pen_type == PEN_COMPOSITOR) {
+        // the compositor has no buffer, its layers do
+        self->buffer = nullptr;
+    } else if(pen_type == PEN_INKY7) {
         self->buffer = m_new_class(PSRamDisplay, width, height);
     } else {
         if (args[ARG_buffer].u_obj != mp_const_none) {
@@ -398,6 +421,10 @@ mp_obj_t ModPicoGraphics_make_new(const mp_obj_type_t *type, size_t n_args, size
         case PEN_INKY7:
             self->graphics = m_new_class(PicoGraphics_PenInky7, self->display->width, self->display->height, *(IDirectDisplayDriver<uint8_t> *)self->buffer);
             break;
+        case PEN_COMPOSITOR:
+            self->compositor = m_new_class(PicoGraphics_Compositor, self->display->width, self->display->height);
+            self->graphics = self->compositor;
+            break;
         default:
             break;
     }
@@ -421,6 +448,8 @@ mp_obj_t ModPicoGraphics_make_new(const mp_obj_type_t *type, size_t n_args, size
 mp_obj_t ModPicoGraphics__del__(mp_obj_t self_in) {
     ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
     self->display->cleanup();
+    // the layer list and row buffers are on the C heap, not the GC heap
+    if(self->compositor) self->compositor->~PicoGraphics_Compositor();
     return mp_const_none;
 }
 
@@ -512,6 +541,8 @@ mp_int_t ModPicoGraphics_get_framebuffer(mp_obj_t self_in, mp_buffer_info_t *buf
 mp_obj_t ModPicoGraphics_set_framebuffer(mp_obj_t self_in, mp_obj_t framebuffer) {
     ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
 
+    if(self->compositor) mp_raise_ValueError("set_framebuffer(): layers own their buffers");
+
     if (framebuffer == mp_const_none) {
         m_del(uint8_t, self->buffer, self->graphics->bounds.w * self->graphics->bounds.h);
         self->buffer = nullptr;
@@ -555,6 +586,110 @@ mp_obj_t ModPicoGraphics_get_bounds(mp_obj_t self_in) {
     return mp_obj_new_tuple(2, tuple);
 }
 
+mp_obj_t ModPicoGraphics_add_layer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_self, ARG_pen_type, ARG_x, ARG_y, ARG_width, ARG_height, ARG_transparent, ARG_alpha };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_pen_type, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_x, MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_y, MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_width, MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_height, MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_transparent, MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_alpha, MP_ARG_INT, {.u_int = 255} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(args[ARG_self].u_obj, ModPicoGraphics_obj_t);
+    if(!self->compositor) mp_raise_ValueError("add_layer(): needs PEN_COMPOSITOR");
+
+    // layers default to the size of the display
+    int width = args[ARG_width].u_int < 0 ? self->compositor->bounds.w : args[ARG_width].u_int;
+    int height = args[ARG_height].u_int < 0 ? self->compositor->bounds.h : args[ARG_height].u_int;
+    if(width == 0 || height == 0) mp_raise_ValueError("add_layer(): empty layer");
+
+    PicoGraphicsPenType pen_type = (PicoGraphicsPenType)args[ARG_pen_type].u_int;
+    void *buffer = nullptr;
+    PicoGraphics *layer = nullptr;
+    switch(pen_type) {
+        case PEN_P4:
+            buffer = m_new(uint8_t, get_required_buffer_size(pen_type, width, height));
+            layer = m_new_class(PicoGraphics_PenP4, width, height, buffer);
+            break;
+        case PEN_P8:
+            buffer = m_new(uint8_t, get_required_buffer_size(pen_type, width, height));
+            layer = m_new_class(PicoGraphics_PenP8, width, height, buffer);
+            break;
+        case PEN_RGB332:
+            buffer = m_new(uint8_t, get_required_buffer_size(pen_type, width, height));
+            layer = m_new_class(PicoGraphics_PenRGB332, width, height, buffer);
+            break;
+        case PEN_RGB565:
+            buffer = m_new(uint8_t, get_required_buffer_size(pen_type, width, height));
+            layer = m_new_class(PicoGraphics_PenRGB565, width, height, buffer);
+            break;
+        case PEN_RGB888:
+            buffer = m_new(uint8_t, get_required_buffer_size(pen_type, width, height));
+            layer = m_new_class(PicoGraphics_PenRGB888, width, height, buffer);
+            break;
+        default:
+            mp_raise_ValueError("add_layer(): unsupported pen type");
+    }
+
+    layer->set_pen(0);
+    layer->clear();
+
+    int index = self->compositor->add_layer(layer, Point(args[ARG_x].u_int, args[ARG_y].u_int), args[ARG_transparent].u_int, args[ARG_alpha].u_int);
+
+    self->layers = m_renew(PicoGraphics *, self->layers, self->layer_count, self->layer_count + 1);
+    self->layers[self->layer_count++] = layer;
+
+    return mp_obj_new_int(index);
+}
+
+mp_obj_t ModPicoGraphics_select_layer(mp_obj_t self_in, mp_obj_t layer) {
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
+    if(!self->compositor) mp_raise_ValueError("select_layer(): needs PEN_COMPOSITOR");
+
+    size_t i = mp_obj_get_int(layer);
+    if(i >= self->compositor->layers.size()) mp_raise_ValueError("select_layer(): no such layer");
+
+    self->graphics = self->compositor->layers[i].graphics;
+    return mp_const_none;
+}
+
+mp_obj_t ModPicoGraphics_set_layer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_self, ARG_layer, ARG_x, ARG_y, ARG_alpha, ARG_visible };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_layer, MP_ARG_REQUIRED | MP_ARG_INT },
+        { MP_QSTR_x, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_y, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_alpha, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_visible, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(args[ARG_self].u_obj, ModPicoGraphics_obj_t);
+    if(!self->compositor) mp_raise_ValueError("set_layer(): needs PEN_COMPOSITOR");
+
+    size_t i = args[ARG_layer].u_int;
+    if(i >= self->compositor->layers.size()) mp_raise_ValueError("set_layer(): no such layer");
+
+    // anything not given is left as it is
+    PicoGraphics_Compositor::Layer &layer = self->compositor->layer(i);
+    if(args[ARG_x].u_obj != mp_const_none) layer.offset.x = mp_obj_get_int(args[ARG_x].u_obj);
+    if(args[ARG_y].u_obj != mp_const_none) layer.offset.y = mp_obj_get_int(args[ARG_y].u_obj);
+    if(args[ARG_alpha].u_obj != mp_const_none) layer.alpha = mp_obj_get_int(args[ARG_alpha].u_obj);
+    if(args[ARG_visible].u_obj != mp_const_none) layer.visible = mp_obj_is_true(args[ARG_visible].u_obj);
+
+    return mp_const_none;
+}
+
 /*
 mp_obj_t ModPicoGraphics_set_scanline_callback(mp_obj_t self_in, mp_obj_t cb_in) {
     ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_obj_t);
@@ -584,7 +719,7 @@ mp_obj_t ModPicoGraphics_update(mp_obj_t self_in) {
     #endif
     }
 
-    self->display->update(self->graphics);
+    self->display->update(self->compositor ? self->compositor : self->graphics);
 
     while(self->display->is_busy()) {
     #ifdef MICROPY_EVENT_POLL_HOOK
@@ -608,7 +743,7 @@ mp_obj_t ModPicoGraphics_partial_update(size_t n_args, const mp_obj_t *args) {
     #endif
     }
 
-    self->display->partial_update(self->graphics, {
+    self->display->partial_update(self->compositor ? self->compositor : self->graphics, {
         mp_obj_get_int(args[ARG_x]),
         mp_obj_get_int(args[ARG_y]),
         mp_obj_get_int(args[ARG_w]),
@@ -926,14 +1061,22 @@ mp_obj_t ModPicoGraphics_text(size_t n_args, const mp_obj_t *pos_args, mp_map_t
 
     mp_obj_t text_obj = args[ARG_text].u_obj;
 
+    int x = args[ARG_x].u_int;
+    int y = args[ARG_y].u_int;
+
+    // a layout has been measured and wrapped already, so wordwrap, scale and spacing are ignored
+    if(mp_obj_is_type(text_obj, &ModPicoGraphics_TextLayout_type)) {
+        ModPicoGraphics_TextLayout_obj_t *layout = MP_OBJ_TO_PTR2(text_obj, ModPicoGraphics_TextLayout_obj_t);
+        self->graphics->text(*layout->layout, Point(x, y), args[ARG_angle].u_int);
+        return mp_const_none;
+    }
+
     if(!mp_obj_is_str_or_bytes(text_obj)) mp_raise_TypeError("text: string required");
 
     GET_STR_DATA_LEN(text_obj, str, str_len);
 
     std::string t((const char*)str);
 
-    int x = args[ARG_x].u_int;
-    int y = args[ARG_y].u_int;
     int wrap = args[ARG_wrap].u_int;
     float scale = args[ARG_scale].u_obj == mp_const_none ? 2.0f : mp_obj_get_float(args[ARG_scale].u_obj);
     int angle = args[ARG_angle].u_int;
@@ -974,6 +1117,71 @@ mp_obj_t ModPicoGraphics_measure_text(size_t n_args, const mp_obj_t *pos_args, m
     return mp_obj_new_int(width);
 }
 
+mp_obj_t ModPicoGraphics_layout_text(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_self, ARG_text, ARG_wrap, ARG_scale, ARG_spacing, ARG_align };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_text, MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_wordwrap, MP_ARG_INT, {.u_int = -1} },  // no wrapping, and lines are aligned to the widest
+        { MP_QSTR_scale, MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_spacing, MP_ARG_INT, {.u_int = 1} },
+        { MP_QSTR_align, MP_ARG_INT, {.u_int = ALIGN_LEFT} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    ModPicoGraphics_obj_t *self = MP_OBJ_TO_PTR2(args[ARG_self].u_obj, ModPicoGraphics_obj_t);
+
+    mp_obj_t text_obj = args[ARG_text].u_obj;
+
+    if(!mp_obj_is_str_or_bytes(text_obj)) mp_raise_TypeError("layout_text: string required");
+
+    GET_STR_DATA_LEN(text_obj, str, str_len);
+
+    std::string t((const char*)str);
+
+    int wrap = args[ARG_wrap].u_int;
+    float scale = args[ARG_scale].u_obj == mp_const_none ? 2.0f : mp_obj_get_float(args[ARG_scale].u_obj);
+    int letter_spacing = args[ARG_spacing].u_int;
+    int align = args[ARG_align].u_int;
+
+    if(align < ALIGN_LEFT || align > ALIGN_RIGHT) mp_raise_ValueError("layout_text: invalid align");
+
+    // the glyph and line lists are on the C heap, __del__ frees them
+    ModPicoGraphics_TextLayout_obj_t *layout = m_new_obj_with_finaliser(ModPicoGraphics_TextLayout_obj_t);
+    layout->base.type = &ModPicoGraphics_TextLayout_type;
+    layout->layout = m_new_class(TextLayout, self->graphics->layout_text(t, wrap, scale, letter_spacing, (TextLayout::Alignment)align));
+
+    return MP_OBJ_FROM_PTR(layout);
+}
+
+mp_obj_t ModPicoGraphics_TextLayout_get_bounds(mp_obj_t self_in) {
+    ModPicoGraphics_TextLayout_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_TextLayout_obj_t);
+    Rect &bounds = self->layout->bounds;
+    mp_obj_t tuple[4] = {
+        mp_obj_new_int(bounds.x),
+        mp_obj_new_int(bounds.y),
+        mp_obj_new_int(bounds.w),
+        mp_obj_new_int(bounds.h)
+    };
+    return mp_obj_new_tuple(4, tuple);
+}
+
+mp_obj_t ModPicoGraphics_TextLayout_hit_test(mp_obj_t self_in, mp_obj_t x, mp_obj_t y) {
+    ModPicoGraphics_TextLayout_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_TextLayout_obj_t);
+    int glyph = self->layout->hit_test(Point(mp_obj_get_int(x), mp_obj_get_int(y)));
+
+    // the byte offset of the character in the string, or -1
+    return mp_obj_new_int(glyph < 0 ? -1 : (int)self->layout->glyphs[glyph].index);
+}
+
+mp_obj_t ModPicoGraphics_TextLayout__del__(mp_obj_t self_in) {
+    ModPicoGraphics_TextLayout_obj_t *self = MP_OBJ_TO_PTR2(self_in, ModPicoGraphics_TextLayout_obj_t);
+    self->layout->~TextLayout();
+    return mp_const_none;
+}
+
 mp_obj_t ModPicoGraphics_polygon(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     size_t num_tuples = n_args - 1;
     const mp_obj_t *tuples = pos_args + 1;
@@ -38,6 +38,7 @@ enum PicoGraphicsPenType {
     PEN_RGB565,
     PEN_RGB888,
     PEN_INKY7,
+    PEN_COMPOSITOR,
 };
 
 enum PicoGraphicsBusType {
@@ -47,8 +48,15 @@ enum PicoGraphicsBusType {
     BUS_PIO
 };
 
+enum PicoGraphicsTextAlign {
+    ALIGN_LEFT = 0,
+    ALIGN_CENTER,
+    ALIGN_RIGHT
+};
+
 // Type
 extern const mp_obj_type_t ModPicoGraphics_type;
+extern const mp_obj_type_t ModPicoGraphics_TextLayout_type;
 
 // Module functions
 extern mp_obj_t ModPicoGraphics_module_RGB_to_RGB332(mp_obj_t r, mp_obj_t g, mp_obj_t b);
@@ -88,6 +96,7 @@ extern mp_obj_t ModPicoGraphics_circle(size_t n_args, const mp_obj_t *args);
 extern mp_obj_t ModPicoGraphics_character(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t ModPicoGraphics_text(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t ModPicoGraphics_measure_text(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t ModPicoGraphics_layout_text(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t ModPicoGraphics_polygon(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t ModPicoGraphics_triangle(size_t n_args, const mp_obj_t *args);
 extern mp_obj_t ModPicoGraphics_line(size_t n_args, const mp_obj_t *args);
@@ -97,6 +106,11 @@ extern mp_obj_t ModPicoGraphics_set_spritesheet(mp_obj_t self_in, mp_obj_t sprit
 extern mp_obj_t ModPicoGraphics_load_spritesheet(mp_obj_t self_in, mp_obj_t filename);
 extern mp_obj_t ModPicoGraphics_sprite(size_t n_args, const mp_obj_t *args);
 
+// Layers
+extern mp_obj_t ModPicoGraphics_add_layer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t ModPicoGraphics_select_layer(mp_obj_t self_in, mp_obj_t layer);
+extern mp_obj_t ModPicoGraphics_set_layer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
 // Utility
 //extern mp_obj_t ModPicoGraphics_set_scanline_callback(mp_obj_t self_in, mp_obj_t cb_in);
 extern mp_obj_t ModPicoGraphics_set_font(mp_obj_t self_in, mp_obj_t font);
@@ -106,3 +120,8 @@ extern mp_obj_t ModPicoGraphics_set_framebuffer(mp_obj_t self_in, mp_obj_t frame
 extern mp_int_t ModPicoGraphics_get_framebuffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_uint_t flags);
 
 extern mp_obj_t ModPicoGraphics__del__(mp_obj_t self_in);
+
+// Text layout
+extern mp_obj_t ModPicoGraphics_TextLayout_get_bounds(mp_obj_t self_in);
+extern mp_obj_t ModPicoGraphics_TextLayout_hit_test(mp_obj_t self_in, mp_obj_t x, mp_obj_t y);
+extern mp_obj_t ModPicoGraphics_TextLayout__del__(mp_obj_t self_in);